@@ -8,109 +8,332 @@
 
 #include <stdlib.h>
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include "DigiCom.h"
 #include "sensors.h"
 #include "controller.h"
+#include "energy.h"
+#include "systime.h"
+#include "speed.h"
+#include "commission.h"
+#include "efficiency.h"
+#include "pid_benchmark.h"
 #include "UniversalModuleDrivers/adc.h"
 #include "UniversalModuleDrivers/spi.h"
 #include "UniversalModuleDrivers/rgbled.h"
 #include "AVR-UART-lib-master/usart.h"
 
-//ADC buffers
-static uint16_t u16_ADC0_reg = 0;
-static uint16_t u16_ADC1_reg = 0;
-static uint16_t u16_ADC2_reg = 0;
-static uint16_t u16_ADC4_reg = 0;
+//ADC buffers (last raw value of each MCP3208 channel)
+static volatile uint16_t u16_ADC_reg[8];
 
 //for SPI
-static uint8_t u8_txBuffer[2];
+static uint8_t u8_txBuffer[3];
 static uint8_t u8_rxBuffer[3];
 
 /////////////////////////  SPI  /////////////////////////
+/* Non blocking acquisition of the external ADC (MCP3208).
+* SPI_request() queues a channel, the conversions are done one after the other by the SPI interrupt
+* (see spi_trancieve_async) and each result is handed to the consumer of its channel (see conversion table).
+* Each channel has its own period (SPI_PERIOD_xxx in DigiCom.h, queued by SPI_schedule_tick() every ms)
+* and priority : pending channels are served highest priority first.
+* Compared with the blocking spi_trancieve (3 bytes at clkio/4 with busy wait on SPIF), no ISR waits on the SPI.
+* The consumers (sensor scaling and filters, energy accumulation) still run inside the SPI interrupt, after the last
+* byte : the CAN and UART interrupts can be delayed by one whole SPI interrupt, consumer included.
+* The cycles of the acquisition ISRs are summed over each ms (systime_isr_cycles()), the highest sum is in the UART
+* telemetry. With SPI_ACQUISITION_BLOCKING (motor_controller_selection.h) the conversions busy wait inside the ISR
+* that starts them, as before : flash both and compare the telemetry to get the ISR time saved per ms.
+*/
 
-void SPI_handler_0(volatile float * p_f32_motcurrent) // motor current
+static volatile ModuleValues_t * p_SPI_vals ;
+
+static void SPI_consumer_0(uint16_t u16_ADC_value) // motor current
 {
-	Set_ADC_Channel_ext(0, u8_txBuffer);
-	spi_trancieve(u8_txBuffer, u8_rxBuffer, 3, 1);
-	u8_rxBuffer[1]&= ~(0b111<<5);
-	u16_ADC0_reg = (u8_rxBuffer[1] << 8 ) | u8_rxBuffer[2];
-	
-	handle_current_sensor(p_f32_motcurrent, u16_ADC0_reg,0);
+	p_SPI_vals->i16_motor_current_sample = current_sensor_mA(u16_ADC_value, 0);
+	handle_current_sensor(&p_SPI_vals->i16_motor_current, u16_ADC_value, 0);
 }
 
-void SPI_handler_1(volatile float * f32_batcurrent) // battery current
+static void SPI_consumer_1(uint16_t u16_ADC_value) // battery current
 {
-	Set_ADC_Channel_ext(1, u8_txBuffer);
-	spi_trancieve(u8_txBuffer, u8_rxBuffer, 3, 1);
-	u8_rxBuffer[1]&= ~(0b111<<5);
-	u16_ADC1_reg = (u8_rxBuffer[1] << 8 ) | u8_rxBuffer[2];
-	
-	handle_current_sensor(f32_batcurrent, u16_ADC1_reg,1);
+	handle_current_sensor(&p_SPI_vals->i16_batt_current, u16_ADC_value, 1);
+	energy_update(p_SPI_vals->u16_batt_volt, current_sensor_mA(u16_ADC_value, 1)); // raw sample, the filter lag would skew V*I
 }
 
-void SPI_handler_2(volatile float * f32_batvolt) //battery voltage
+static void SPI_consumer_2(uint16_t u16_ADC_value) //battery voltage
 {
-	Set_ADC_Channel_ext(2, u8_txBuffer);
-	spi_trancieve(u8_txBuffer, u8_rxBuffer, 3, 1);
-	u8_rxBuffer[1]&= ~(0b111<<5);
-	u16_ADC2_reg = (u8_rxBuffer[1] << 8 ) | u8_rxBuffer[2];
+	handle_voltage_sensor(&p_SPI_vals->u16_batt_volt, u16_ADC_value);
+}
+
+static void SPI_consumer_4(uint16_t u16_ADC_value) //motor temperature
+{
+	handle_temp_sensor(&p_SPI_vals->u8_motor_temp, u16_ADC_value);
+}
+
+typedef struct {
+	uint8_t u8_channel ;
+	uint16_t u16_period_ms ; // 0 : not scheduled, requested by the caller (PWM synchronous)
+	uint8_t u8_priority ; // highest served first
+	void (*consumer)(uint16_t u16_ADC_value) ;
+} SpiConversion_t ;
+
+//conversion table
+static const SpiConversion_t SPI_conversions[] = {
+	{0, SPI_PERIOD_MOTOR_CURRENT, 3, SPI_consumer_0}, // motor current
+	{1, SPI_PERIOD_BATT_CURRENT, 2, SPI_consumer_1}, // battery current
+	{2, SPI_PERIOD_BATT_VOLT, 2, SPI_consumer_2}, // battery voltage
+	{4, SPI_PERIOD_MOTOR_TEMP, 0, SPI_consumer_4}  // motor temperature
+};
+#define SPI_NUM_CONVERSIONS (sizeof(SPI_conversions)/sizeof(SpiConversion_t))
+
+static volatile uint8_t u8_SPI_pending = 0 ; //one bit per entry of the conversion table
+static uint8_t u8_SPI_current = 0 ; //entry being converted
+static uint16_t u16_SPI_countdown[SPI_NUM_CONVERSIONS] ; //ms until the next scheduled conversion
+static volatile uint16_t u16_SPI_samples[SPI_NUM_CONVERSIONS] ; //conversions done (wraps around), see SPI_sample_count()
+
+//capture of one conversion, with the time it started (see SPI_capture_arm())
+#define SPI_CAPTURE_IDLE 0
+#define SPI_CAPTURE_ARMED 1
+#define SPI_CAPTURE_STARTED 2
+#define SPI_CAPTURE_DONE 3
+static volatile uint8_t u8_SPI_capture_state = SPI_CAPTURE_IDLE ;
+static uint8_t u8_SPI_capture_entry = 0 ;
+static volatile uint16_t u16_SPI_capture_value = 0 ;
+static volatile uint32_t u32_SPI_capture_time = 0 ;
+
+static void SPI_conversion_done(void);
+
+static void SPI_start_next(void)
+{
+	uint8_t u8_next = SPI_NUM_CONVERSIONS ;
 	
-	*f32_batvolt = VOLT_CONVERSION_OFFSET+(float)u16_ADC2_reg/VOLT_CONVERSION_COEFF;
+	for (uint8_t n = 0; n < SPI_NUM_CONVERSIONS; n++)
+	{
+		if ((u8_SPI_pending & (1 << n)) && (u8_next == SPI_NUM_CONVERSIONS || SPI_conversions[n].u8_priority > SPI_conversions[u8_next].u8_priority))
+		{
+			u8_next = n ;
+		}
+	}
+	
+	if (u8_next < SPI_NUM_CONVERSIONS)
+	{
+		u8_SPI_pending &= ~(1 << u8_next);
+		u8_SPI_current = u8_next ;
+		if (u8_SPI_capture_state == SPI_CAPTURE_ARMED && u8_next == u8_SPI_capture_entry)
+		{
+			u32_SPI_capture_time = systime_us() ; //the MCP3208 samples during the first bits
+			u8_SPI_capture_state = SPI_CAPTURE_STARTED ;
+		}
+		Set_ADC_Channel_ext(SPI_conversions[u8_next].u8_channel, u8_txBuffer);
+		u8_txBuffer[2] = 0 ;
+		#ifdef SPI_ACQUISITION_BLOCKING
+		spi_trancieve(u8_txBuffer, u8_rxBuffer, 3, true); //busy wait, then the next pending conversion
+		SPI_conversion_done();
+		#else
+		spi_trancieve_async(u8_txBuffer, u8_rxBuffer, 3, SPI_conversion_done);
+		#endif
+	}
 }
 
-void SPI_handler_4(volatile uint8_t * u8_mottemp) //motor temperature
+static void SPI_conversion_done(void) // called from the SPI interrupt (from SPI_start_next() with SPI_ACQUISITION_BLOCKING)
 {
-	Set_ADC_Channel_ext(4, u8_txBuffer);
-	spi_trancieve(u8_txBuffer, u8_rxBuffer, 3, 1);
 	u8_rxBuffer[1]&= ~(0b111<<5);
-	u16_ADC4_reg = (u8_rxBuffer[1] << 8 ) | u8_rxBuffer[2];
+	uint16_t u16_value = (u8_rxBuffer[1] << 8 ) | u8_rxBuffer[2];
+	u16_ADC_reg[SPI_conversions[u8_SPI_current].u8_channel] = u16_value ;
+	u16_SPI_samples[u8_SPI_current] ++ ;
+	if (u8_SPI_capture_state == SPI_CAPTURE_STARTED && u8_SPI_current == u8_SPI_capture_entry)
+	{
+		u16_SPI_capture_value = u16_value ;
+		u8_SPI_capture_state = SPI_CAPTURE_DONE ;
+	}
 	
-	handle_temp_sensor(u8_mottemp, u16_ADC4_reg);
+	SPI_conversions[u8_SPI_current].consumer(u16_value);
+	SPI_start_next();
 }
 
+void SPI_acquisition_init(volatile ModuleValues_t * vals)
+{
+	p_SPI_vals = vals ;
+	u8_SPI_pending = 0 ;
+	for (uint8_t n = 0; n < SPI_NUM_CONVERSIONS; n++)
+	{
+		u16_SPI_countdown[n] = n ; //spreading the first conversions
+		u16_SPI_samples[n] = 0 ;
+	}
+}
 
-///////////////////////  CAN  /////////////////////////
+void SPI_schedule_tick(void) // every ms, from the timer 1 ISR
+{
+	for (uint8_t n = 0; n < SPI_NUM_CONVERSIONS; n++)
+	{
+		if (SPI_conversions[n].u16_period_ms != 0)
+		{
+			if (u16_SPI_countdown[n] == 0)
+			{
+				u8_SPI_pending |= (1 << n);
+				u16_SPI_countdown[n] = SPI_conversions[n].u16_period_ms ;
+			}
+			u16_SPI_countdown[n] -- ;
+		}
+	}
+}
 
+uint16_t SPI_sample_count(uint8_t u8_channel)
+{
+	uint16_t u16_count = 0 ;
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t n = 0; n < SPI_NUM_CONVERSIONS; n++)
+	{
+		if (SPI_conversions[n].u8_channel == u8_channel)
+		{
+			u16_count = u16_SPI_samples[n] ;
+		}
+	}
+	SREG = sreg;
+	return u16_count ;
+}
 
-//receiving
-void handle_can(volatile ModuleValues_t *vals, CanMessage_t *rx){
-	if (can_read_message_if_new(rx) && vals->motor_status != ERR){
-		switch (rx->id){
-			case DASHBOARD_CAN_ID	: //receiving can messages from the steering wheel
-				
-				vals->message_mode = CAN ;
-				vals->ctrl_type = CURRENT ;
-				vals->u16_watchdog_can = WATCHDOG_CAN_RELOAD_VALUE ; // resetting to max value each time a message is received.
-				if (rx->data.u8[3] > 8)
-				{
-					vals->u8_accel_cmd = rx->data.u8[3]/8 ; 
-					vals->u16_watchdog_throttle = WATCHDOG_THROTTLE_RELOAD_VALUE ;
-				}
-				
-				if (rx->data.u8[2] > 8)
-				{
-					vals->u8_brake_cmd = rx->data.u8[2]/10 ;
-					vals->u16_watchdog_throttle = WATCHDOG_THROTTLE_RELOAD_VALUE ;
-				}
-				
-				if (rx->data.u8[2] <= 8)
-				{
-					vals->u8_brake_cmd = 0;
-				}
-				if (rx->data.u8[3] <= 8)
-				{
-					vals->u8_accel_cmd = 0;
-				}
-				
-			break;
-			
-			case E_CLUTCH_CAN_ID :
-				vals->pwtrain_type = GEAR ;
-				vals->u16_motor_speed = rx->data.u16[0] ; //receiving motor speed from encoder from clutch board
-				vals->gear_status = rx->data.u8[2] ; //receiving gear status from the clutch board
-			break;
+void SPI_capture_arm(uint8_t u8_channel)
+{
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t n = 0; n < SPI_NUM_CONVERSIONS; n++)
+	{
+		if (SPI_conversions[n].u8_channel == u8_channel)
+		{
+			u8_SPI_capture_entry = n ;
+			u8_SPI_capture_state = SPI_CAPTURE_ARMED ;
+		}
+	}
+	SREG = sreg;
+}
+
+uint8_t SPI_capture_read(uint16_t *u16_ADC_value, uint32_t *u32_time_us)
+{
+	uint8_t b_done = 0 ;
+	uint8_t sreg = SREG;
+	cli();
+	if (u8_SPI_capture_state == SPI_CAPTURE_DONE)
+	{
+		*u16_ADC_value = u16_SPI_capture_value ;
+		*u32_time_us = u32_SPI_capture_time ;
+		u8_SPI_capture_state = SPI_CAPTURE_IDLE ;
+		b_done = 1 ;
+	}
+	SREG = sreg;
+	return b_done ;
+}
+
+void SPI_queue(uint8_t u8_channel)
+{
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t n = 0; n < SPI_NUM_CONVERSIONS; n++)
+	{
+		if (SPI_conversions[n].u8_channel == u8_channel)
+		{
+			u8_SPI_pending |= (1 << n);
 		}
 	}
+	SREG = sreg;
+}
+
+void SPI_request(uint8_t u8_channel)
+{
+	uint8_t sreg = SREG;
+	cli();
+	SPI_queue(u8_channel);
+	if (!spi_busy())
+	{
+		SPI_start_next();
+	}
+	SREG = sreg;
+}
+
+
+///////////////////////  CAN  /////////////////////////
+
+#ifdef DASHBOARD_CRUISE_BYTES
+static uint8_t u8_dashboard_cruise_kmh = 0 ; //last cruise control target received, the brakes cancel it until it changes
+static uint8_t u8_dashboard_band_kmh = 0 ; //last pulse and glide speed band received
+#endif
+
+static volatile ModuleValues_t *p_CAN_vals ; //values written by the CAN handlers, set by handle_can()
+
+static void CAN_dashboard_handler(uint16_t u16_id, uint8_t u8_length, const CanData_t *data) //steering wheel
+{
+	volatile ModuleValues_t *vals = p_CAN_vals ;
+	
+	vals->message_mode = CAN ;
+	vals->ctrl_type = CURRENT ;
+	vals->u16_watchdog_can = WATCHDOG_CAN_RELOAD_VALUE ; // resetting to max value each time a message is received.
+	if (data->u8[3] > 8)
+	{
+		vals->u8_accel_cmd = data->u8[3]/8 ; 
+		vals->u16_watchdog_throttle = WATCHDOG_THROTTLE_RELOAD_VALUE ;
+	}
+	
+	if (data->u8[2] > 8)
+	{
+		vals->u8_brake_cmd = data->u8[2]/10 ;
+		vals->u16_watchdog_throttle = WATCHDOG_THROTTLE_RELOAD_VALUE ;
+	}
+	
+	if (data->u8[2] <= 8)
+	{
+		vals->u8_brake_cmd = 0;
+	}
+	if (data->u8[3] <= 8)
+	{
+		vals->u8_accel_cmd = 0;
+	}
+	
+	#ifdef DASHBOARD_CRUISE_BYTES
+	if (u8_length > 4 && data->u8[4] != u8_dashboard_cruise_kmh) //cruise control target in km/h (0 : off), on change only
+	{
+		u8_dashboard_cruise_kmh = data->u8[4] ;
+		cruise_set_kmh(vals, u8_dashboard_cruise_kmh);
+	}
+	if (u8_length > 5 && data->u8[5] != u8_dashboard_band_kmh) //pulse and glide speed band in km/h (0 : constant speed)
+	{
+		u8_dashboard_band_kmh = data->u8[5] ;
+		cruise_set_band_kmh(vals, u8_dashboard_band_kmh);
+	}
+	#endif
+}
+
+static void CAN_clutch_handler(uint16_t u16_id, uint8_t u8_length, const CanData_t *data)
+{
+	volatile ModuleValues_t *vals = p_CAN_vals ;
+	
+	vals->pwtrain_type = GEAR ;
+	vals->u16_motor_speed = data->u16[0] ; //receiving motor speed from encoder from clutch board
+	speed_encoder_sample();
+	vals->gear_status = data->u8[2] ; //receiving gear status from the clutch board
+}
+
+//hardware acceptance filters and handlers, one CAN MOb per ID. The other frames (other motor, BMS...) are not
+//received at all, no interrupt. A group of IDs takes one MOb with a mask, e.g. {BMS_CELL_V_1_4_CAN_ID, 0x7F0, handler}.
+static const CanFilter_t can_filters[] = {
+	{DASHBOARD_CAN_ID, 0x7FF, CAN_dashboard_handler},
+	{E_CLUTCH_CAN_ID, 0x7FF, CAN_clutch_handler}
+};
+#define CAN_FILTERS (sizeof(can_filters)/sizeof(can_filters[0]))
+
+void CAN_filters_init(void)
+{
+	can_init_filters(can_filters, CAN_FILTERS); //the reset message is received in the next MOb
+}
+
+//receiving : all the frames received since the last call, read in place in the CAN receive buffer
+void handle_can(volatile ModuleValues_t *vals)
+{
+	p_CAN_vals = vals ;
+	if (vals->motor_status == ERR)
+	{
+		can_flush();
+	}else{
+		can_dispatch();
+	}
 }
 
 //sending
@@ -120,10 +343,10 @@ void handle_motor_status_can_msg(volatile ModuleValues_t vals){
 	txFrame.length = 8;
 	
 	txFrame.data.u8[0] = vals.motor_status;
-	txFrame.data.i8[1] = (int8_t)(vals.f32_motor_current*10);
-	txFrame.data.u16[1] = (uint16_t)(vals.f32_batt_volt*10);
-	txFrame.data.u16[2] = (uint16_t)abs((int16_t)vals.f32_energy/100.0) ;
-	txFrame.data.u8[6] = (uint8_t)(vals.u16_car_speed*3.6*0.5) ; //sent in km/h
+	txFrame.data.i8[1] = (int8_t)(vals.i16_motor_current/100);
+	txFrame.data.u16[1] = vals.u16_batt_volt/100;
+	txFrame.data.u16[2] = (uint16_t)abs((int16_t)(energy_get_J()/100)) ;
+	txFrame.data.u8[6] = (uint8_t)(vals.u16_car_speed_mm_s*0.036*0.5) ; //sent in km/h
 	txFrame.data.u8[7] = vals.u8_motor_temp;
 		
 	can_send_message(&txFrame);
@@ -132,9 +355,10 @@ void handle_motor_status_can_msg(volatile ModuleValues_t vals){
 void handle_clutch_cmd_can_msg(volatile ModuleValues_t vals){
 	
 	txFrame1.id = MOTOR_CL_CMD_CAN_ID;
-	txFrame1.length = 1;
+	txFrame1.length = 2;
 
 	txFrame1.data.u8[0] = vals.gear_required;
+	txFrame1.data.u8[1] = vals.b_speed_synch; //1 : motor at the wheel speed, the dogs can be engaged (2 byte frame, the clutch board reads it)
 		
 	can_send_message(&txFrame1);
 }
@@ -149,7 +373,33 @@ void receive_uart(volatile ModuleValues_t * vals)
 		int16_t i16_data_received=uart_getint();
 		uart_flush();
 		vals->u16_watchdog_can = WATCHDOG_CAN_RELOAD_VALUE ;
-		if (vals->ctrl_type == CURRENT)
+		if (i16_data_received == COMMISSION_UART_CMD) //motor identification, from IDLE (see state_machine.c)
+		{
+			vals->b_commission_request = 1 ;
+		}else if (i16_data_received >= CRUISE_UART_CMD && i16_data_received <= CRUISE_UART_CMD+CRUISE_MAX_KMH) //cruise control
+		{
+			vals->u8_accel_cmd = 0 ;
+			vals->u8_brake_cmd = 0 ;
+			cruise_set_kmh(vals, (uint8_t)(i16_data_received-CRUISE_UART_CMD));
+		}else if (i16_data_received >= PULSE_GLIDE_UART_CMD && i16_data_received <= PULSE_GLIDE_UART_CMD+CRUISE_MAX_BAND_KMH) //pulse and glide band
+		{
+			cruise_set_band_kmh(vals, (uint8_t)(i16_data_received-PULSE_GLIDE_UART_CMD));
+		}else if (i16_data_received == LAP_UART_CMD)
+		{
+			energy_lap_request();
+		}else if (i16_data_received == EFFICIENCY_EXPORT_UART_CMD)
+		{
+			efficiency_export_request();
+		}else if (i16_data_received == EFFICIENCY_RESET_UART_CMD)
+		{
+			efficiency_learn_reset();
+		}else if (i16_data_received == PID_BENCH_UART_CMD)
+		{
+			if (vals->motor_status == IDLE || vals->motor_status == OFF) //interrupts are held for up to 8 pid_update()
+			{
+				pid_benchmark_request();
+			}
+		}else if (vals->ctrl_type == CURRENT || vals->ctrl_type == DEADBEAT)
 		{
 			if (i16_data_received > -10 && i16_data_received < 0) //limited braking and acceleration at 10A
 			{
@@ -174,11 +424,11 @@ void send_uart(volatile ModuleValues_t vals)
 	//printf("%i,%i,%u,%u,%u,%u,%i",(int16_t)(vals.f32_motor_current*1000),(int16_t)(vals.f32_batt_current*1000),(uint16_t)(vals.f32_batt_volt*1000),vals.u8_car_speed,vals.u8_duty_cycle,vals.u8_motor_temp,vals.i8_throttle_cmd);
 	printf("\r\n");
 	
-	/*printf("batt curr : %i",(int16_t)(vals.f32_batt_current*10));
+	/*printf("batt curr : %i",vals.i16_batt_current/100);
 	printf(",");
-	printf(" batt volt : %u",(uint16_t)(vals.f32_batt_volt*10));
+	printf(" batt volt : %u",vals.u16_batt_volt/100);
 	printf(",");
-	printf(" mot curr : %i",(int16_t)(vals.f32_motor_current*10));
+	printf(" mot curr : %i",vals.i16_motor_current/100);
 	printf(",");
 	printf(" duty : %u",vals.u8_duty_cycle);
 	printf(",");
@@ -190,31 +440,83 @@ void send_uart(volatile ModuleValues_t vals)
 		printf(" cmd : %i",-(int8_t)vals.u8_brake_cmd);
 	}
 	printf(",");
-	printf("speed km/h : %u",(uint16_t)(vals.u16_car_speed*3.6));
+	printf("speed km/h : %u",(uint16_t)(vals.u16_car_speed_mm_s*0.0036));
 	printf(",");
 	printf(" gear req : %u",vals.gear_required);
 	printf(",");
 	printf(" gear status : %u",vals.gear_status);
 	printf(",");
-	printf(" ctrl mode (0:Cur, 1:PWM) : %u",vals.ctrl_type);
+	printf(" ctrl mode (0:Cur, 1:PWM, 2:Deadbeat) : %u",vals.ctrl_type);
 	printf(",");
 	printf(" motor mode : %u",vals.motor_status);
 	*/
 	
-	printf("%i",(int16_t)(vals.f32_motor_current*1000));
+	printf("%i",vals.i16_motor_current);
 	printf(",");
 	printf("%u",vals.u8_duty_cycle);
 	printf(",");
 	printf("%u",vals.u8_accel_cmd*1000);
 	printf(",");
-	printf("%u",(uint16_t)(vals.u16_car_speed*360.0));	// vehicle speed in m/h
+	printf("%u",(uint16_t)(vals.u16_car_speed_mm_s*3.6));	// vehicle speed in m/h
 	printf(",");
 	//printf("%u",(uint16_t)(vals.u16_motor_speed/4.29));
 	printf("%u",(uint16_t)(vals.u16_motor_speed*5.03));	// vehicle speed in m/h = rpm*18/375/60*2*pi*0.556/2*3.6
 	printf(",");
-	printf("%u",(uint16_t)(vals.f32_batt_volt*10));
+	printf("%u",vals.u16_batt_volt/100);
+	printf(",");
+	printf("%i",vals.i16_batt_current);
+	printf(",");
+	printf("%li",energy_get_mWh());
+	printf(",");
+	printf("%li",energy_get_regen_mWh());
+	printf(",");
+	printf("%li",energy_get_mAh());
+	printf(",");
+	printf("%li",energy_get_peak_power_mW());
+	printf(",");
+	printf("%li",energy_get_average_power_mW());
+	printf(",");
+	printf("%u",vals.u16_engage_time);
+	printf(",");
+	printf("%u",(uint16_t)(controller_get_R()*1000.0)); // mohm
+	printf(",");
+	printf("%u",(uint16_t)(controller_get_L()*1000000.0)); // uH
+	printf(",");
+	printf("%u",vals.b_cruise ? vals.u16_cruise_speed : 0); // cruise control target in mm/s, 0 when not in control
+	printf(",");
+	printf("%u",vals.u16_cruise_band); // pulse and glide band in mm/s
 	printf(",");
-	printf("%i",(int16_t)(vals.f32_batt_current*1000));
+	printf("%u",energy_get_lap_count());
+	printf(",");
+	printf("%li",energy_get_lap_J()); // last lap
+	printf(",");
+	printf("%u",energy_get_lap_s());
+	printf(",");
+	printf("%u",energy_get_lap_m());
+	printf(",");
+	printf("%u",energy_get_lap_mode()); // 0 : manual, 1 : cruise, 2 : pulse and glide
+	for (uint8_t u8_i = 0; u8_i <= CAN_FILTERS; u8_i++) // frames received by each CAN filter, then the reset message
+	{
+		printf(",");
+		printf("%u",can_get_rx_count(u8_i));
+	}
+	printf(",");
+	printf("%u",can_get_rx_dropped()); // CAN receive buffer full
+	for (uint8_t n = 0; n < SPI_NUM_CONVERSIONS; n++) // conversions of each external ADC channel, in table order (wraps around, the rate is the difference between two lines)
+	{
+		printf(",");
+		printf("%u",SPI_sample_count(SPI_conversions[n].u8_channel));
+	}
+	printf(",");
+	printf("%u",vals.u16_ctrl_cycles_max); // longest current loop, in CPU cycles
+	printf(",");
+	printf("%u",systime_isr_cycles_max()); // highest cycles per ms in the acquisition ISRs
+	printf(",");
+	printf("%u",vals.u16_sample_misses); // motor current samples taken too late, skipped
+	#ifdef CURRENT_LOOP_PWM_SYNC
+	printf(",");
+	printf("%u",vals.u16_ctrl_overruns);
+	#endif
 	
 }
 
@@ -258,6 +560,12 @@ void manage_LEDs(volatile ModuleValues_t vals)
 			rgbled_turn_on(LED_GREEN);
 		break;
 		
+		case COMMISSION :
+			rgbled_turn_off(LED_GREEN);
+			rgbled_turn_on(LED_BLUE);
+			rgbled_toggle(LED_RED);
+		break;
+		
 		case ERR :
 			rgbled_turn_off(LED_GREEN);
 			rgbled_turn_off(LED_BLUE);
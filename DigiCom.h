@@ -16,23 +16,31 @@
 
 
 // CAN Types
-CanMessage_t rxFrame;
 CanMessage_t txFrame;
-CanMessage_t rxFrame1;
 CanMessage_t txFrame1;
 
 ///////////////// PROTOTYPES //////////////s
 
 //SPI
-void SPI_handler_0(volatile float * f32_motcurrent); // motor current
-void SPI_handler_1(volatile float * f32_batcurrent); // battery current
-void SPI_handler_2(volatile float * f32_batvolt); //battery voltage
-void SPI_handler_4(volatile uint8_t * u8_mottemp); //motor temperature
+//conversion periods of the external ADC channels, in ms (0 : requested by the caller)
+#define SPI_PERIOD_MOTOR_CURRENT 0 //synchronous with the PWM (see timer 3 in main.c)
+#define SPI_PERIOD_BATT_CURRENT 4
+#define SPI_PERIOD_BATT_VOLT 4
+#define SPI_PERIOD_MOTOR_TEMP 100
+
+void SPI_acquisition_init(volatile ModuleValues_t * vals); //results of the external ADC conversions are written in vals
+void SPI_request(uint8_t u8_channel); //queues a conversion of the external ADC channel and starts it if the SPI is free, returns immediately
+void SPI_queue(uint8_t u8_channel); //queues a conversion, started after the one in progress (or the next SPI_request)
+void SPI_schedule_tick(void); //queues the channels that are due (SPI_PERIOD_xxx), to call every ms
+uint16_t SPI_sample_count(uint8_t u8_channel); //number of conversions done on the channel (wraps around)
+void SPI_capture_arm(uint8_t u8_channel); //keeps the next conversion of the channel started after this call, with its start time
+uint8_t SPI_capture_read(uint16_t *u16_ADC_value, uint32_t *u32_time_us); //1 when the armed conversion is done (raw ADC value, start time in us)
 
 //CAN
+void CAN_filters_init(void); //CAN controller with one receive filter and handler per CAN ID
 void handle_motor_status_can_msg(volatile ModuleValues_t vals); //sending status
 void handle_clutch_cmd_can_msg(volatile ModuleValues_t vals); //sending required gear to clutch
-void handle_can(volatile ModuleValues_t *vals, CanMessage_t *rx); //receiving
+void handle_can(volatile ModuleValues_t *vals); //receiving, every frame waiting
 
 //UART
 void receive_uart(volatile ModuleValues_t * vals);
@@ -28,7 +28,7 @@ typedef union {
 		uint32_t filler3	: 1;
 		uint32_t id			:11;
 		uint32_t length		: 4;
-		uint32_t filler4	: 4;
+		uint32_t mob		: 4;		//RX Mob of the frame, index of its filter + 1
 		uint8_t	data[CAN_FRAME_DATA_MAX_LENGTH];
 	};
 	unsigned char		array[CAN_FRAME_MSG_LENGTH + CAN_FRAME_DATA_MAX_LENGTH];
@@ -109,6 +109,8 @@ typedef union {
 #warning:Wrong CAN RX Buffer Size
 #endif
 
+#define CAN_MOBS		15			//Mob 0 : TX, RX from Mob 1
+
 #define RX_ABS_MASK		0x7F
 #define TX_ABS_MASK		0x7F
 
@@ -121,8 +123,12 @@ static uint8_t tx_off;
 static uint8_t tx_on;
 static uint8_t tx_busy;
 static uint8_t rx_off;
-static uint8_t rx_on;
+static volatile uint8_t rx_on;
 static volatile uint8_t reset;
+static uint8_t rx_mobs;						//RX Mobs in use, from Mob 1
+static volatile uint16_t rx_count[CAN_RX_FILTERS_MAX+1];	//frames accepted by each RX Mob
+static volatile uint16_t rx_dropped;		//frames lost, RX buffer full
+static const CanFilter_t* rx_filters;		//handlers of can_dispatch(), by Mob
 
 /**************************************************************************************************
 *   CAN ISR - See 'can.h' Header file for Description
@@ -131,10 +137,10 @@ ISR(CANIT_vect)
 {
 	volatile uint8_t mob_status;
 
-	uint8_t mob_interrupts = CANSIT2;
+	uint8_t mob = CANHPMOB >> HPMOB0;		//highest priority Mob with an interrupt, 0xF if none
 
 	// TX
-	if ((mob_interrupts & (1 << SIT0)) && (CANIE2 & (1 << ENMOB0))) {
+	if (mob == 0 && (CANIE2 & (1 << ENMOB0))) {
 		CANPAGE = (0x0 << MOBNB0); //Select TX Mob (Mob0)
 		mob_status = CANSTMOB;
 		CANSTMOB &= ~(1 << TXOK); //clear MB1, TX interrupt
@@ -165,14 +171,16 @@ ISR(CANIT_vect)
 		}
 	}
 	// RX
-	else if ((mob_interrupts & (1 << SIT1)) && (CANIE2 & (1 << ENMOB1))) {
-		//Select RX Mob (Mob1)
-		CANPAGE = (0x1 << MOBNB0);
+	else if (mob >= 1 && mob <= rx_mobs) {
+		//Select the RX Mob of the filter
+		CANPAGE = (mob << MOBNB0);
+		rx_count[mob-1]++;
 		if (((rx_on - rx_off) & RX_ABS_MASK) < RX_SIZE) {
 			unsigned char pos;
 			pos = rx_on & (RX_SIZE-1);
 			//Read length
 			rx_frames[pos].length = CANCDMOB & 0x0F;
+			rx_frames[pos].mob = mob;
 			//Read ID
 			rx_frames[pos].array[0] = (CANIDT2 & 0xE0) | (CANIDT4 & 0x07);
 			rx_frames[pos].array[1] = CANIDT1;
@@ -189,10 +197,12 @@ ISR(CANIT_vect)
 			rx_on++;
 
 			// Reset if reset can message
-			if(rx_frames[pos].id == 0x000 && rx_frames[pos].data[0] == 0x03){
+			if(rx_frames[pos].id == CAN_RESET_ID && rx_frames[pos].data[0] == 0x03){
 				wdt_enable(WDTO_15MS);
 				while(1); //wait for watchdog
 			}
+		} else {
+			rx_dropped++;
 		}
 
 		// Clear irq
@@ -200,13 +210,39 @@ ISR(CANIT_vect)
 		(void)mob_status;
 
 		CANSTMOB &= ~(1 << RXOK);
-		CANCDMOB = (1 << CONMOB1);			//Set Mob 1 as RX
+		CANCDMOB = (1 << CONMOB1);			//Set the Mob as RX again
 
 	}
 }
 
+/**************************************************************************************************
+*   Acceptance filter of a RX Mob : standard (2.0A) frames whose ID bits set in the mask are
+*   the ones of the tag. Mask 0 : every frame.
+**************************************************************************************************/
+static void can_rx_mob(uint8_t mob, uint16_t accept_mask_id, uint16_t accept_tag_id) {
+	CANPAGE = (mob << MOBNB0);
+	CANSTMOB = 0;
+	CANIDM4 = (accept_mask_id != 0) ? (1 << IDEMSK) : 0;	//extended frames are rejected by the filters
+	CANIDM2 = (accept_mask_id << 5) & 0xFF;
+	CANIDM1 = (accept_mask_id >> 3) & 0xFF;
+	CANIDT4 = 0;
+	CANIDT2 = (accept_tag_id << 5) & 0xFF;
+	CANIDT1 = (accept_tag_id >> 3) & 0xFF;
+
+	// Set the Mob as RX
+	CANCDMOB = (1 << CONMOB1);
 
-void can_init(uint16_t accept_mask_id, uint16_t accept_tag_id) {
+	// Enable the Mob and its interrupt
+	if (mob < 8) {
+		CANEN2 |= (1 << mob);
+		CANIE2 |= (1 << mob);
+	} else {
+		CANEN1 |= (1 << (mob - 8));
+		CANIE1 |= (1 << (mob - 8));
+	}
+}
+
+static void can_setup(void) {
 	// Reset CAN controller
 	CANGCON = (1 << SWRES);
 
@@ -220,29 +256,34 @@ void can_init(uint16_t accept_mask_id, uint16_t accept_tag_id) {
 	CANHPMOB = 0;
 	CANTCON = 0;
 
+	// Disable all the Mobs, the ones used are enabled below
+	for (uint8_t mob = 0; mob < CAN_MOBS; mob++) {
+		CANPAGE = (mob << MOBNB0);
+		CANSTMOB = 0;
+		CANCDMOB = 0;
+	}
+	CANEN1 = 0;
+	CANEN2 = 0;
+	CANIE1 = 0;
+	CANIE2 = 0;
+
 	// Switch to Mob 0 access
 	CANPAGE = (0x0 << MOBNB0);
 	CANSTMOB = 0;
 
-	// Switch to Mob 1 access
-	CANPAGE = (0x1 << MOBNB0);
-	CANSTMOB = 0;
-	CANIDM4 = 0;
-	CANIDM2 = (accept_mask_id << 5) & 0xFF;
-	CANIDM1 = (accept_mask_id >> 3) & 0xFF;
-	CANIDT4 = 0;
-	CANIDT2 = (accept_tag_id << 5) & 0xFF;
-	CANIDT1 = (accept_tag_id >> 3) & 0xFF;
-
-	// Set Mob 1 as RX
-	CANCDMOB = (1 << CONMOB1);
+	for (uint8_t i = 0; i <= CAN_RX_FILTERS_MAX; i++) {
+		rx_count[i] = 0;
+	}
+	rx_dropped = 0;
+	rx_filters = 0;
+}
 
-	// Enable Mob 0 and 1
-	CANEN2 = (1 << ENMOB1) | (1 << ENMOB0);
-	// Enable Mob 0 and 1 Interrupt
-	CANIE2 = (1 << ENMOB1) | (1 << ENMOB0);
+static void can_start(void) {
+	// Enable Mob 0 (TX) and its interrupt
+	CANEN2 |= (1 << ENMOB0);
+	CANIE2 |= (1 << ENMOB0);
 	// Enable TX and RX interrupt
-	CANGIE = (1 << ENIT) | (1 << ENRX) | (1 << ENTX);	
+	CANGIE = (1 << ENIT) | (1 << ENRX) | (1 << ENTX);
 
 	// Enable CAN controller
 	CANGCON = (1 << ENASTB);
@@ -250,6 +291,74 @@ void can_init(uint16_t accept_mask_id, uint16_t accept_tag_id) {
 	reset = 0;
 }
 
+
+void can_init(uint16_t accept_mask_id, uint16_t accept_tag_id) {
+	can_setup();
+
+	// Mob 1 RX, one filter for all the frames
+	can_rx_mob(1, accept_mask_id, accept_tag_id);
+	rx_mobs = 1;
+
+	can_start();
+}
+
+void can_init_filters(const CanFilter_t *filters, uint8_t count) {
+	if (count > CAN_RX_FILTERS_MAX) {
+		count = CAN_RX_FILTERS_MAX;
+	}
+	can_setup();
+
+	// Mob 1 to count RX, one per filter
+	for (uint8_t i = 0; i < count; i++) {
+		can_rx_mob(i + 1, filters[i].mask, filters[i].id);
+	}
+	// Next Mob : reset message, always received
+	can_rx_mob(count + 1, 0x7FF, CAN_RESET_ID);
+	rx_mobs = count + 1;
+	rx_filters = filters;
+
+	can_start();
+}
+
+uint16_t can_get_rx_count(uint8_t filter) {
+	uint16_t count = 0;
+	if (filter < rx_mobs) {
+		CANGIE &= ~(1 << ENIT);
+		count = rx_count[filter];
+		CANGIE |= (1 << ENIT);
+	}
+	return count;
+}
+
+uint16_t can_get_rx_dropped(void) {
+	CANGIE &= ~(1 << ENIT);
+	uint16_t count = rx_dropped;
+	CANGIE |= (1 << ENIT);
+	return count;
+}
+
+uint8_t can_dispatch(void) {
+	uint8_t count = 0;
+
+	// Every frame in the buffer, the ones received meanwhile too, within one buffer length
+	while (rx_on != rx_off && count < RX_SIZE) {
+		can_frame* frame = &rx_frames[(rx_off & (RX_SIZE - 1))];
+		uint8_t filter = frame->mob - 1;
+
+		// Read in place : the slot is only given back to the ISR after the handler
+		if (rx_filters != 0 && filter < rx_mobs - 1 && rx_filters[filter].handler != 0) {
+			rx_filters[filter].handler(frame->id, frame->length, (const CanData_t*)frame->data);
+		}
+		rx_off++;
+		count++;
+	}
+	return count;
+}
+
+void can_flush(void) {
+	rx_off = rx_on;
+}
+
 bool can_read_message_if_new(CanMessage_t* message) {
 	// Check if there is a new message
 	if (rx_on == rx_off) {
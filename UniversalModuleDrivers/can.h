@@ -26,6 +26,7 @@
 #define BMS_VOLT_CURRENT_CAN_ID 0x444
 #define BMS_STATUS_CAN_ID		0x448
 #define BMS_ERROR_CAN_ID		0x449
+#define CAN_RESET_ID			0x000	//data[0] = 0x03 resets the module, received with any filters
 
 typedef union {
 	// Integers and fixed point numbers
@@ -64,7 +65,29 @@ typedef struct {
 	CanData_t data;
 } CanMessage_t;
 
-void can_init(uint16_t accept_mask_id, uint16_t accept_tag_id);
+// Receive handler, the frame is read in place in the RX buffer (valid during the call only)
+typedef void (*CanHandler_t)(uint16_t id, uint8_t length, const CanData_t* data);
+
+// Hardware acceptance filter : a frame is received if (id & mask) == (filter id & mask)
+typedef struct {
+	uint16_t id;
+	uint16_t mask;		//0x7FF : this ID only, 0x7F0 : the 16 IDs of a group
+	CanHandler_t handler;	//called by can_dispatch(), 0 : none
+} CanFilter_t;
+
+#define CAN_RX_FILTERS_MAX	13	//Mob 1 to 13, Mob 14 for the reset message
+
+void can_init(uint16_t accept_mask_id, uint16_t accept_tag_id);	//one RX Mob, mask 0 : every frame
+
+void can_init_filters(const CanFilter_t* filters, uint8_t count);	//one RX Mob per filter, and the reset message. The table is kept
+
+uint8_t can_dispatch(void);		//calls the handler of the filter of each frame received, until the RX buffer is empty. Returns the number of frames
+
+void can_flush(void);		//drops the frames received
+
+uint16_t can_get_rx_count(uint8_t filter);	//frames received by a filter (in the order of can_init_filters(), then the reset message)
+
+uint16_t can_get_rx_dropped(void);	//frames lost, RX buffer full
 
 bool can_read_message_if_new(CanMessage_t* message);
 
@@ -36,11 +36,12 @@ void pwm_init(void){
 		TCCR3B &= ~((1<<CS32)|(1<<CS31));
 		
 		//Set top value for timer 3
-		ICR3 = 0x85; //30kHz  0x85, 20kHz : 0x100
+		ICR3 = PWM_TOP; //30kHz  0x85, 20kHz : 0x100 (see pwm.h)
 
 		
 		OCR3A = (int)((0.5)*ICR3) ; //PWM_PE3 (non inverted)
 		OCR3B = OCR3A ; //PWM_PE4 (inverted)
+		OCR3C = PWM_SAMPLE_POINT_BIPOLAR(OCR3A) ; //motor current sampling point
 		
 	}else{//UNIPOLAR
 		
@@ -63,10 +64,11 @@ void pwm_init(void){
 		TCCR3B &= ~((1<<CS32)|(1<<CS31));
 		
 		//Set top value for timer 3
-		ICR3 = 0x85; //30kHz  0x85, 20kHz : 0x100
+		ICR3 = PWM_TOP; //30kHz  0x85, 20kHz : 0x100 (see pwm.h)
 		
 		//initialising compare registers at Duty cycle 50%
 		OCR3A = (int)((0.5)*ICR3) ; //PWM_PE3
 		OCR3B = ICR3-OCR3A ; //PWM_PE4
+		OCR3C = PWM_SAMPLE_POINT_UNIPOLAR ; //motor current sampling point
 	}
 }
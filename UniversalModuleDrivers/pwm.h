@@ -13,6 +13,27 @@
 //defining PWM switching scheme
 #define SW_MODE UNIPOLAR
 
+//top value of timer 3 (ICR3) : 30kHz  0x85, 20kHz : 0x100
+#define PWM_TOP 0x85
+//PWM period in CPU cycles and frequency (phase correct in UNIPOLAR, fast PWM in BIPOLAR, see pwm.c)
+#define PWM_PERIOD_CYCLES ((SW_MODE == BIPOLAR) ? (PWM_TOP+1) : (2*PWM_TOP))
+#define PWM_FREQ ((float)F_CPU/PWM_PERIOD_CYCLES)
+
+//Motor current sampling point : compare match C (the OC3C pin is not driven by the timer).
+//A sample is armed at BOTTOM (timer 3 overflow, see main.c) and started by the next compare match C, on the up count.
+//Latency from the compare match to the MCP3208 sampling instant : interrupt + SPI_request() ~130 cycles,
+//+ 11 SPI clocks at clkio/4. Must stay between PWM_TOP and 2*PWM_TOP-40 in UNIPOLAR.
+#define PWM_SAMPLE_LATENCY 180 //in CPU cycles
+//Highest TCNT3-OCR3C read at the start of the compare match C ISR (entry ~30 cycles), over that the ISR was delayed
+//by another one and the sample would miss the average : it is skipped and counted (see main.c). A counter past TOP
+//(ICF3 set, ICR3 is TOP in both modes) is late as well.
+#define PWM_SAMPLE_WINDOW 60 //in CPU cycles
+//UNIPOLAR : the motor current equals its average at BOTTOM and TOP. Sampled at the next BOTTOM
+#define PWM_SAMPLE_POINT_UNIPOLAR (2*PWM_TOP-PWM_SAMPLE_LATENCY)
+//BIPOLAR : middle of the on time of PWM_PE3 in the next period. At 60kHz the latency is longer than
+//the period, the sample then lands at most ~50 cycles after the middle of the on time.
+#define PWM_SAMPLE_POINT_BIPOLAR(ocr) (((ocr)/2+PWM_TOP+1 < PWM_SAMPLE_LATENCY+40) ? 40 : ((ocr)/2+PWM_TOP+1-PWM_SAMPLE_LATENCY))
+
 typedef enum {
 	UNIPOLAR = 0,
 	BIPOLAR = 1
@@ -6,13 +6,23 @@
  */ 
 
 #include "spi.h"
+#include "../systime.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
 
 #define DDR_SPI DDRB
 #define PIN_MOSI PB2
 #define PIN_SCK PB1
 #define PIN_SS PB0
 
+// interrupt driven transmission
+static uint8_t* async_tx_buffer;
+static uint8_t* async_rx_buffer;
+static size_t async_length;
+static volatile size_t async_index;
+static spi_callback_t async_callback;
+static volatile bool async_busy = false;
+
 void spi_init(spi_prescale_t clock_prescale) {
 	// Set MOSI, SS, and SCK output, all others input
 	DDR_SPI |= (1 << PIN_MOSI) | (1 << PIN_SCK) | (1 << PIN_SS);
@@ -66,3 +76,45 @@ void spi_trancieve_tx_then_rx(uint8_t* tx_buffer, size_t tx_length, uint8_t* rx_
 
 	PORTB |= (1 << PIN_SS);
 }
+
+bool spi_trancieve_async(uint8_t* tx_buffer, uint8_t* rx_buffer, size_t length, spi_callback_t callback) {
+	if (async_busy || length == 0) {
+		return false;
+	}
+
+	async_tx_buffer = tx_buffer;
+	async_rx_buffer = rx_buffer;
+	async_length = length;
+	async_index = 0;
+	async_callback = callback;
+	async_busy = true;
+
+	PORTB &= ~(1 << PIN_SS);
+	SPCR |= (1 << SPIE);
+	SPDR = (tx_buffer != NULL) ? tx_buffer[0] : 0xFF;
+
+	return true;
+}
+
+bool spi_busy(void) {
+	return async_busy;
+}
+
+ISR(SPI_STC_vect) {
+	uint16_t u16_start = TCNT1; // interrupt load, callback included (see systime.h)
+	size_t i = async_index;
+
+	if (async_rx_buffer != NULL) async_rx_buffer[i] = SPDR;
+	i++;
+
+	if (i < async_length) {
+		async_index = i;
+		SPDR = (async_tx_buffer != NULL) ? async_tx_buffer[i] : 0xFF;
+	} else {
+		PORTB |= (1 << PIN_SS);
+		SPCR &= ~(1 << SPIE);
+		async_busy = false;
+		if (async_callback != NULL) async_callback();
+	}
+	systime_isr_cycles(u16_start);
+}
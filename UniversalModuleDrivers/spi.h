@@ -38,5 +38,16 @@ void spi_trancieve(uint8_t* tx_buffer, uint8_t* rx_buffer, size_t length, bool l
 // it is needed to split the transmission across several memory locations.
 void spi_trancieve_tx_then_rx(uint8_t* tx_buffer, size_t tx_length, uint8_t* rx_buffer, size_t rx_length);
 
+typedef void (*spi_callback_t)(void);
+
+// Interrupt driven version of spi_trancieve. Starts the transmission and returns immediately, the
+// following bytes are sent from the SPI interrupt. Slave select is deasserted and callback (if not NULL)
+// is called from the SPI interrupt once the last byte is received. The buffers must stay valid until then.
+// Returns false (and does nothing) if an interrupt driven transmission is already running.
+// Do not mix with the blocking functions while a transmission is running.
+bool spi_trancieve_async(uint8_t* tx_buffer, uint8_t* rx_buffer, size_t length, spi_callback_t callback);
+
+bool spi_busy(void);
+
 
 #endif /* SPI_H_ */
\ No newline at end of file
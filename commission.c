@@ -0,0 +1,265 @@
+/*
+ * commission.c
+ *
+ * Created: 13/05/2018 15:20:31
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : Motor Drive V2.1
+ */
+
+////////////////  DESCRIPTION  ////////////
+/* Identification of the motor winding at standstill, started from IDLE with a UART command (see receive_uart()).
+* Resistance : the duty cycle is raised from 50% (0V in UNIPOLAR) until the motor current reaches COMMISSION_CURRENT/2,
+* held and averaged, then raised again until COMMISSION_CURRENT. R = dV/dI between the two points, so that the
+* voltage lost in the bridge (dead time, diodes), large next to the test voltage, does not count as resistance.
+* The voltages are the ones of the compare values written in timer 3 (a count is 0.75% of the battery voltage), not
+* the ones of the duty cycle in %, which differ by up to a count.
+* Inductance : COMMISSION_TRIALS voltage steps from 0V to the same duty cycle. One raw current sample is taken
+* after each step, at the time given by the SPI capture (see SPI_capture_arm()). Its distance to the step varies
+* with the sampling phase, so the samples cover the rise. Each one gives the electrical time constant
+* tau = -t/ln(1-i/I), and L = R*tau with the average of the valid ones.
+* The results are applied to the current loop and saved in the EEPROM, they are loaded at start up.
+*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>
+#include <math.h>
+#include "commission.h"
+#include "controller.h"
+#include "sensors.h"
+#include "DigiCom.h"
+#include "systime.h"
+#include "UniversalModuleDrivers/pwm.h"
+
+#define COMMISSION_MAGIC 0xC0A1
+#define R_MIN 0.02 //ohm, plausible range of the results
+#define R_MAX 5.0
+#define L_MIN 0.00001 //H
+#define L_MAX 0.01
+
+//durations in state machine steps of 5ms
+#define SETTLE_STEPS 20 //100ms at 0V before the measurement
+#define RAMP_STEPS 10 //50ms between duty cycle increments
+#define HOLD_STEPS 20 //100ms after the current is reached, then averaged over 100ms
+#define ZERO_STEPS 6 //30ms at 0V before each inductance step (about 40 L/R)
+#define STEP_DELAY_US (500000.0/PWM_FREQ) //the new compare value is loaded at the end of the PWM period, on average half a period after the write
+
+typedef enum
+{
+	PHASE_SETTLE,
+	PHASE_RAMP,
+	PHASE_HOLD,
+	PHASE_AVERAGE,
+	PHASE_ZERO,
+	PHASE_STEP
+} CommissionPhase_t ;
+
+typedef struct
+{
+	uint16_t u16_magic ;
+	float f32_R ;
+	float f32_L ;
+} CommissionRecord_t ;
+
+static EEMEM CommissionRecord_t ee_record ;
+
+static CommissionPhase_t phase = PHASE_SETTLE ;
+static uint8_t u8_count = 0 ;
+static uint8_t u8_duty = 50 ;
+static uint8_t u8_test_duty = 50 ; //duty cycle of the resistance measurement, used for the inductance steps
+static uint8_t u8_trial = 0 ;
+static uint8_t u8_tau_count = 0 ;
+static int32_t i32_current_sum = 0 ;
+static uint32_t u32_volt_sum = 0 ;
+static uint8_t u8_point = 0 ; //resistance measured between two points, at COMMISSION_CURRENT/2 and COMMISSION_CURRENT
+static float f32_I1 = 0.0 ;
+static float f32_V1 = 0.0 ;
+static float f32_I = 0.0 ; //A, steady current at u8_test_duty
+static float f32_R = 0.0 ;
+static float f32_tau_sum = 0.0 ;
+static uint32_t u32_step_time = 0 ;
+static volatile uint8_t b_save_pending = 0 ;
+
+static float applied_voltage_ratio(void) //motor voltage over battery voltage, from the compare values written by controller()
+{
+	if (SW_MODE == BIPOLAR)
+	{
+		return (2.0*(float)OCR3A-PWM_TOP)/PWM_TOP ;
+	}
+	return ((float)OCR3A-(float)OCR3B)/PWM_TOP ; //UNIPOLAR, each of them truncated to a count
+}
+
+static uint8_t plausible(float f32_res, float f32_ind)
+{
+	return (f32_res >= R_MIN && f32_res <= R_MAX && f32_ind >= L_MIN && f32_ind <= L_MAX) ;
+}
+
+void commission_init(void)
+{
+	CommissionRecord_t record ;
+	eeprom_read_block(&record, &ee_record, sizeof(record));
+	if (record.u16_magic == COMMISSION_MAGIC && plausible(record.f32_R, record.f32_L))
+	{
+		controller_set_motor(record.f32_R, record.f32_L);
+	}else{
+		controller_set_motor(R, L); //compile time values of the motor (see controller.h)
+	}
+}
+
+void commission_start(void)
+{
+	phase = PHASE_SETTLE ;
+	u8_count = 0 ;
+	u8_duty = 50 ;
+	u8_point = 0 ;
+	u8_trial = 0 ;
+	u8_tau_count = 0 ;
+	f32_tau_sum = 0.0 ;
+}
+
+CommissionStatus_t commission_step(volatile ModuleValues_t *vals)
+{
+	if (vals->u16_car_speed != 0 || (vals->gear_status != NEUTRAL && vals->u16_motor_speed > COMMISSION_MAX_RPM))
+	{
+		u8_duty = 50 ; //the motor turns : the back EMF spoils the measurement
+		vals->u8_duty_cycle = u8_duty ;
+		controller(vals);
+		return COMMISSION_FAILED ;
+	}
+
+	CommissionStatus_t status = COMMISSION_RUNNING ;
+	uint8_t b_step = 0 ;
+	uint16_t u16_ADC_value = 0 ;
+	uint32_t u32_sample_time = 0 ;
+	u8_count ++ ;
+
+	switch (phase)
+	{
+		case PHASE_SETTLE:
+			u8_duty = 50 ;
+			if (u8_count >= SETTLE_STEPS)
+			{
+				u8_duty = 51 ;
+				u8_count = 0 ;
+				phase = PHASE_RAMP ;
+			}
+		break;
+
+		case PHASE_RAMP:
+			if (vals->i16_motor_current >= ((u8_point == 0) ? (COMMISSION_CURRENT/2) : COMMISSION_CURRENT))
+			{
+				u8_count = 0 ;
+				phase = PHASE_HOLD ;
+			}else if (u8_count >= RAMP_STEPS)
+			{
+				u8_count = 0 ;
+				if (u8_duty >= COMMISSION_MAX_DUTY)
+				{
+					u8_duty = 50 ;
+					status = COMMISSION_FAILED ; //open winding or current sensor
+				}else{
+					u8_duty ++ ;
+				}
+			}
+		break;
+
+		case PHASE_HOLD:
+			if (u8_count >= HOLD_STEPS)
+			{
+				i32_current_sum = 0 ;
+				u32_volt_sum = 0 ;
+				u8_count = 0 ;
+				phase = PHASE_AVERAGE ;
+			}
+		break;
+
+		case PHASE_AVERAGE:
+			i32_current_sum += vals->i16_motor_current ;
+			u32_volt_sum += vals->u16_batt_volt ;
+			if (u8_count >= HOLD_STEPS)
+			{
+				f32_I = (float)i32_current_sum/(1000.0*HOLD_STEPS) ;
+				float f32_V = applied_voltage_ratio()*(float)u32_volt_sum/(1000.0*HOLD_STEPS) ; //u8_duty held since PHASE_HOLD
+				u8_count = 0 ;
+				if (u8_point == 0)
+				{
+					f32_I1 = f32_I ;
+					f32_V1 = f32_V ;
+					u8_point = 1 ;
+					u8_duty ++ ;
+					phase = PHASE_RAMP ;
+				}else if (f32_I - f32_I1 > 0.1*COMMISSION_CURRENT/1000.0)
+				{
+					f32_R = (f32_V-f32_V1)/(f32_I-f32_I1) ; //the voltage drop of the bridge (dead time, diodes) cancels out
+					u8_test_duty = u8_duty ;
+					phase = PHASE_ZERO ;
+				}else{
+					u8_duty = 50 ;
+					status = COMMISSION_FAILED ;
+				}
+			}
+		break;
+
+		case PHASE_ZERO:
+			u8_duty = 50 ;
+			if (u8_count >= ZERO_STEPS)
+			{
+				u8_duty = u8_test_duty ;
+				b_step = 1 ;
+				u8_count = 0 ;
+				phase = PHASE_STEP ;
+			}
+		break;
+
+		case PHASE_STEP: //the capture is done within 1ms of the step (PWM_SYNC : CURRENT_LOOP_PWM_DIVISOR PWM periods)
+			if (SPI_capture_read(&u16_ADC_value, &u32_sample_time))
+			{
+				float f32_t = (float)(u32_sample_time - u32_step_time) - STEP_DELAY_US ;
+				float f32_ratio = (float)current_sensor_mA(u16_ADC_value, 0)/(1000.0*f32_I) ;
+				if (f32_t > 0.0 && f32_ratio > 0.1 && f32_ratio < 0.9) //too close to the step or to the steady state
+				{
+					f32_tau_sum += -f32_t/log(1.0-f32_ratio) ;
+					u8_tau_count ++ ;
+				}
+			}
+			u8_duty = 50 ;
+			u8_count = 0 ;
+			u8_trial ++ ;
+			phase = PHASE_ZERO ;
+			if (u8_trial >= COMMISSION_TRIALS)
+			{
+				float f32_L = (u8_tau_count >= COMMISSION_TRIALS/4) ? (f32_R*f32_tau_sum/(1000000.0*u8_tau_count)) : 0.0 ;
+				if (plausible(f32_R, f32_L))
+				{
+					controller_set_motor(f32_R, f32_L);
+					b_save_pending = 1 ; //see commission_handler()
+					status = COMMISSION_DONE ;
+				}else{
+					status = COMMISSION_FAILED ;
+				}
+			}
+		break;
+	}
+
+	vals->u8_duty_cycle = u8_duty ;
+	controller(vals); //PWM mode, applies the duty cycle
+	if (b_step)
+	{
+		u32_step_time = systime_us() ;
+		SPI_capture_arm(0); //next motor current conversion, started after the new compare value is written
+	}
+	return status ;
+}
+
+void commission_handler(void)
+{
+	if (b_save_pending)
+	{
+		CommissionRecord_t record ;
+		record.u16_magic = COMMISSION_MAGIC ;
+		record.f32_R = controller_get_R() ;
+		record.f32_L = controller_get_L() ;
+		eeprom_update_block(&record, &ee_record, sizeof(record));
+		b_save_pending = 0 ;
+	}
+}
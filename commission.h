@@ -0,0 +1,35 @@
+/*
+ * commission.h
+ *
+ * Created: 13/05/2018 15:20:48
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : Motor Drive V2.1
+ */
+
+#ifndef COMMISSION_H_
+#define COMMISSION_H_
+
+#include <avr/io.h>
+#include "state_machine.h"
+
+// Motor commissioning : identification of the winding resistance and inductance at standstill (COMMISSION state)
+// The car has to be held still (brakes) so that the motor cannot turn.
+#define COMMISSION_UART_CMD 1000 //value to send through UART to start the commissioning from IDLE
+#define COMMISSION_CURRENT 5000 //mA, current of the resistance measurement and of the inductance steps
+#define COMMISSION_MAX_DUTY 65 //%, the ramp stops there if the current is not reached
+#define COMMISSION_TRIALS 32 //inductance steps
+#define COMMISSION_MAX_RPM 30 //the motor turning (clutch encoder) aborts the commissioning
+
+typedef enum
+{
+	COMMISSION_RUNNING,
+	COMMISSION_DONE,
+	COMMISSION_FAILED
+} CommissionStatus_t ;
+
+void commission_init(void); //loads R and L from the EEPROM into the current loop, the defaults of controller.h if none were saved
+void commission_start(void);
+CommissionStatus_t commission_step(volatile ModuleValues_t *vals); //every 5ms in COMMISSION, applies the duty cycle
+void commission_handler(void); //in the main loop, saves the results in the EEPROM (too slow for the ISR)
+
+#endif /* COMMISSION_H_ */
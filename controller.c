@@ -6,76 +6,480 @@
  */ 
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <math.h>
 #include "UniversalModuleDrivers/usbdb.h"
 #include "UniversalModuleDrivers/adc.h"
 #include "UniversalModuleDrivers/pwm.h"
 #include "state_machine.h"
 #include "pid.h"
 #include "controller.h"
+#include "speed.h"
 
-const float Kp=L*2300.0*0.4 ; //1500*L 2300*L
-const float Ki=R*100.0*0.7 ; //100*R
-const float TimeStep = 0.005 ; //5ms (see timer 0 in main.c)
+static float f32_motor_R = R ; // ohm
+static float f32_motor_L = L ; // H
+
+// CURRENT_LOOP_VBATT_NOM/Vbatt in Q8, every 2048mV from GAIN_SCHEDULE_V0
+#define GAIN_SCHEDULE_Q8(n) ((uint16_t)(256.0*CURRENT_LOOP_VBATT_NOM*1000.0/(GAIN_SCHEDULE_V0+((uint32_t)(n) << GAIN_SCHEDULE_SHIFT))+0.5))
+static const uint16_t PROGMEM u16_gain_schedule[GAIN_SCHEDULE_SIZE] = {
+	GAIN_SCHEDULE_Q8(0),GAIN_SCHEDULE_Q8(1),GAIN_SCHEDULE_Q8(2),GAIN_SCHEDULE_Q8(3),GAIN_SCHEDULE_Q8(4),GAIN_SCHEDULE_Q8(5),
+	GAIN_SCHEDULE_Q8(6),GAIN_SCHEDULE_Q8(7),GAIN_SCHEDULE_Q8(8),GAIN_SCHEDULE_Q8(9),GAIN_SCHEDULE_Q8(10),GAIN_SCHEDULE_Q8(11),
+	GAIN_SCHEDULE_Q8(12),GAIN_SCHEDULE_Q8(13),GAIN_SCHEDULE_Q8(14),GAIN_SCHEDULE_Q8(15),GAIN_SCHEDULE_Q8(16),GAIN_SCHEDULE_Q8(17),
+	GAIN_SCHEDULE_Q8(18),GAIN_SCHEDULE_Q8(19),GAIN_SCHEDULE_Q8(20),GAIN_SCHEDULE_Q8(21)
+};
+
+static uint16_t gain_schedule_q8(uint16_t u16_batt_volt) // linear interpolation, 0.5% from CURRENT_LOOP_VBATT_NOM/Vbatt
+{
+	if (u16_batt_volt <= GAIN_SCHEDULE_V0)
+	{
+		return pgm_read_word(&u16_gain_schedule[0]) ;
+	}
+	uint16_t u16_offset = u16_batt_volt - GAIN_SCHEDULE_V0 ;
+	uint8_t u8_index = u16_offset >> GAIN_SCHEDULE_SHIFT ;
+	if (u8_index >= GAIN_SCHEDULE_SIZE-1)
+	{
+		return pgm_read_word(&u16_gain_schedule[GAIN_SCHEDULE_SIZE-1]) ;
+	}
+	uint16_t u16_frac = u16_offset & ((1 << GAIN_SCHEDULE_SHIFT)-1) ;
+	uint16_t u16_g0 = pgm_read_word(&u16_gain_schedule[u8_index]) ;
+	uint16_t u16_g1 = pgm_read_word(&u16_gain_schedule[u8_index+1]) ;
+	return u16_g0 - (uint16_t)(((uint32_t)(u16_g0-u16_g1)*u16_frac) >> GAIN_SCHEDULE_SHIFT) ; // decreasing
+}
+
+static int16_t current_cmd_q8(volatile ModuleValues_t *vals) // current command of ACCEL and BRAKE, in Q8.8 A
+{
+	int16_t i16_Cmd = 0 ;
+	if (vals->motor_status == BRAKE)
+	{
+		i16_Cmd = -((int16_t)vals->u8_brake_cmd << 8) ;
+	}
+	if (vals->motor_status == ACCEL)
+	{
+		#ifdef TORQUE_SPLIT
+		i16_Cmd = (int16_t)(((int32_t)vals->u16_accel_current*8389) >> 15) ; // efficiency split (see torque_command()), mA to Q8.8 A
+		#else
+		i16_Cmd = (int16_t)vals->u8_accel_cmd << 8 ;
+		#endif
+	}
+	if (vals->b_cruise && (vals->motor_status == ACCEL || vals->motor_status == BRAKE))
+	{
+		i16_Cmd = (int16_t)(((int32_t)vals->i16_cruise_current*8389) >> 15) ; // speed loop (see cruise_control()), mA to Q8.8 A
+	}
+	return i16_Cmd ;
+}
+
+#ifdef CURRENT_LOOP_FIXED_POINT
+// Fixed point current loop :
+// duty cycle and integrator in Q16.16 (% of duty), currents in Q8.8 (A), gains in Q16 (below 0.5 before the gain schedule).
+// The duty cycle matches the float loop within one OCR3 count.
+#define Q16_ONE 65536L
+#define DUTY_Q16(duty) ((int32_t)(duty)*Q16_ONE)
+#define OCR_SCALE ((uint32_t)(PWM_TOP*65536UL/100)) // OCR3 counts per % of duty, in Q16
+
+#define GAIN_Q16_MAX 0.49
+
+static int16_t i16_Kp_nom = (int16_t)(KP_GAIN*Q16_ONE) ; // at CURRENT_LOOP_VBATT_NOM, scheduled at each step
+static int16_t i16_KiTs_nom = (int16_t)(KI_GAIN*CONTROLLER_TIMESTEP*Q16_ONE) ;
+static int32_t i32_R_mV_per_A = (int32_t)(R*1000.0+0.5) ;
+
+// PI on the current (Q8.8 A) with outputs in Q16.16 % of duty (gains in Q16, see pid.h)
+static Pid_t current_pid = { // Kp and KiTs are set at each step (gain schedule)
+	.i16_KdTs = 0,
+	.u16_KtTs = (uint16_t)(KT_TIMESTEP*PID_KT_ONE),
+	.u16_d_filter = PID_FILTER_NONE,
+	.p_weight = PID_P_ON_ERROR, // with the feed forward, on the error to the reference model (see controller())
+	.i32_out_min = DUTY_Q16(50), // no rheostatic braking and backwards motion
+	.i32_out_max = DUTY_Q16(95) // bootstrap capacitors
+};
+static int32_t i32_FF_emf = 0 ; // back-EMF feed forward, in Q16.16 % of duty above 50%
+static int32_t i32_FF_r_per_A = 0 ; // R.I feed forward per A of current command, in Q16.16 % of duty
+static uint16_t u16_DB_g_q8 = 0 ; // deadbeat a/(1-a), in Q8 (see controller_set_motor())
+static uint16_t u16_DB_age_q12 = 0 ; // deadbeat decay of the current since the sample, in Q12
+static int16_t i16_Ref = 0 ; // reference model : current at the start of the step, in Q8.8 A
+static int16_t i16_RefCmd = 0 ; // command of the last step, in Q8.8 A
+static uint16_t u16_REF_a_q15 = 0 ; // reference model decay over one step, in Q15 (see controller_set_motor())
+static uint16_t u16_REF_as_q15 = 0 ; // and from the start of the step to the sample
+static int16_t i16_RefMin = 0 ; // currents reachable at 50% and 95% of duty, in Q8.8 A (see controller_feedforward())
+static int16_t i16_RefMax = 0 ;
+
+void reset_I(void)
+{
+	pid_set_integrator(&current_pid, 0);
+	i16_Ref = 0 ; // from coasting
+	i16_RefCmd = 0 ;
+}
+
+void set_I(uint8_t duty) // presets the loop output to duty (with no current error)
+{
+	#ifdef CURRENT_LOOP_FEEDFORWARD
+	pid_set_integrator(&current_pid, DUTY_Q16(duty)-DUTY_Q16(50)-i32_FF_emf);
+	#else
+	pid_set_integrator(&current_pid, DUTY_Q16(duty)-DUTY_Q16(50));
+	#endif
+	i16_Ref = 0 ;
+	i16_RefCmd = 0 ;
+}
+
+static int32_t ri_duty_q16(int16_t i16_Cmd) // R.I of a Q8.8 A current, in Q16.16 % of duty (integer and fractional A apart, to stay in 32 bits)
+{
+	return i32_FF_r_per_A*(i16_Cmd >> 8) + ((i32_FF_r_per_A*(i16_Cmd & 0xFF)) >> 8) ;
+}
+
+static int32_t model_duty_q16(int16_t i16_Cmd) // back-EMF and R.I of the command, in Q16.16 % of duty above 50%
+{
+	int32_t i32_FF = i32_FF_emf + ri_duty_q16(i16_Cmd) ;
+	if (i32_FF > DUTY_Q16(95-50)) // bounded on its own, so that the anti windup only acts on the PI part
+	{
+		i32_FF = DUTY_Q16(95-50) ;
+	}
+	if (i32_FF < 0)
+	{
+		i32_FF = 0 ;
+	}
+	return i32_FF ;
+}
+
+void controller_feedforward(volatile ModuleValues_t *vals) // every 5ms, from the speed and the battery voltage
+{
+	if (vals->u16_batt_volt == 0)
+	{
+		i32_FF_emf = 0 ;
+		i32_FF_r_per_A = 0 ;
+		i16_RefMin = 0 ;
+		i16_RefMax = 0 ;
+		return ;
+	}
+	int32_t i32_emf = ((int32_t)motor_speed_estimate(vals)*EMF_MV_PER_RPM_Q8) >> 8 ; // mV
+	if (i32_emf > vals->u16_batt_volt)
+	{
+		i32_emf = vals->u16_batt_volt ;
+	}
+	// duty = 50% + 50%*V/Vbatt, V/Vbatt in Q15 first to stay in 32 bits
+	i32_FF_emf = ((i32_emf << 15)/vals->u16_batt_volt)*100 ;
+	i32_FF_r_per_A = ((i32_R_mV_per_A << 15)/vals->u16_batt_volt)*100 ;
+	// the reference model does not go beyond what the bounds of the duty cycle give : 0V to 90% of Vbatt (UNIPOLAR)
+	i16_RefMin = pid_sat16(-(i32_emf << 8)/i32_R_mV_per_A) ;
+	i16_RefMax = pid_sat16(((((int32_t)vals->u16_batt_volt*(95-50))/50 - i32_emf) << 8)/i32_R_mV_per_A) ;
+}
+
+#else
+static float Kp=KP_GAIN ;
+static float Ki=KI_GAIN ;
+const float TimeStep = CONTROLLER_TIMESTEP ;
+const float KtTs = KT_TIMESTEP ;
 
 static float f32_Integrator = 0.0 ;
+static float f32_FF_emf = 0.0 ; // back-EMF feed forward, in % of duty above 50%
+static float f32_FF_r_per_A = 0.0 ; // R.I feed forward per A of current command, in % of duty
+static float f32_DB_g = 0.0 ; // deadbeat a/(1-a) (see controller_set_motor())
+static float f32_DB_age = 0.0 ; // deadbeat decay of the current since the sample
+static float f32_Ref = 0.0 ; // reference model : current at the start of the step (A)
+static float f32_RefCmd = 0.0 ; // command of the last step (A)
+static float f32_REF_a = 0.0 ; // reference model decay over one step (see controller_set_motor())
+static float f32_REF_as = 0.0 ; // and from the start of the step to the sample
+static float f32_RefMin = 0.0 ; // currents reachable at 50% and 95% of duty, in A (see controller_feedforward())
+static float f32_RefMax = 0.0 ;
 
 void reset_I(void)
 {
 	f32_Integrator = 0;
+	f32_Ref = 0.0 ; // from coasting
+	f32_RefCmd = 0.0 ;
 }
 
-void set_I(uint8_t duty)
+void set_I(uint8_t duty) // presets the loop output to duty (with no current error)
 {
+	#ifdef CURRENT_LOOP_FEEDFORWARD
+	f32_Integrator = (duty-50.0-f32_FF_emf)/Ki;
+	#else
 	f32_Integrator = (duty-50.0)/Ki;
+	#endif
+	f32_Ref = 0.0 ;
+	f32_RefCmd = 0.0 ;
 }
 
+static float model_duty(float f32_Cmd) // back-EMF and R.I of the command (A), in % of duty above 50%
+{
+	float f32_FF = f32_FF_emf + f32_FF_r_per_A*f32_Cmd ;
+	if (f32_FF > 95.0-50.0) // bounded on its own, so that the anti windup only acts on the PI part
+	{
+		f32_FF = 95.0-50.0 ;
+	}
+	if (f32_FF < 0.0)
+	{
+		f32_FF = 0.0 ;
+	}
+	return f32_FF ;
+}
+
+void controller_feedforward(volatile ModuleValues_t *vals) // every 5ms, from the speed and the battery voltage
+{
+	if (vals->u16_batt_volt == 0)
+	{
+		f32_FF_emf = 0.0 ;
+		f32_FF_r_per_A = 0.0 ;
+		f32_RefMin = 0.0 ;
+		f32_RefMax = 0.0 ;
+		return ;
+	}
+	float f32_emf = (float)motor_speed_estimate(vals)/VOLT_SPEED_CST*1000.0 ; // mV
+	if (f32_emf > vals->u16_batt_volt)
+	{
+		f32_emf = vals->u16_batt_volt ;
+	}
+	f32_FF_emf = 50.0*f32_emf/(float)vals->u16_batt_volt ;
+	f32_FF_r_per_A = 50.0*f32_motor_R*1000.0/(float)vals->u16_batt_volt ;
+	// the reference model does not go beyond what the bounds of the duty cycle give : 0V to 90% of Vbatt (UNIPOLAR)
+	f32_RefMin = -f32_emf/(f32_motor_R*1000.0) ;
+	f32_RefMax = ((float)vals->u16_batt_volt*(95.0-50.0)/50.0 - f32_emf)/(f32_motor_R*1000.0) ;
+}
+#endif
+
+void controller_set_motor(float f32_R, float f32_L)
+{
+	float f32_Kp = KP_FROM_L(f32_L) ;
+	float f32_Ki = KI_FROM_RL(f32_R, f32_L) ;
+	float f32_a = exp(-CONTROLLER_TIMESTEP*f32_R/f32_L) ; // current step response after one loop step
+	float f32_g = f32_a/(1.0-f32_a) ;
+	if (f32_g > DEADBEAT_GAIN_MAX)
+	{
+		f32_g = DEADBEAT_GAIN_MAX ;
+	}
+	float f32_age = exp(-DEADBEAT_SAMPLE_AGE*CONTROLLER_TIMESTEP*f32_R/f32_L) ;
+	float f32_as = exp(-(1.0-DEADBEAT_SAMPLE_AGE)*CONTROLLER_TIMESTEP*f32_R/f32_L) ; // start of the step to the sample
+	
+	uint8_t sreg = SREG;
+	cli(); // the PWM synchronous current loop runs from the timer 3 ISR
+	f32_motor_R = f32_R ;
+	f32_motor_L = f32_L ;
+	#ifdef CURRENT_LOOP_FIXED_POINT
+	if (f32_Kp > GAIN_Q16_MAX)
+	{
+		f32_Kp = GAIN_Q16_MAX ;
+	}
+	if (f32_Ki*CONTROLLER_TIMESTEP > GAIN_Q16_MAX)
+	{
+		f32_Ki = GAIN_Q16_MAX/CONTROLLER_TIMESTEP ;
+	}
+	i16_Kp_nom = (int16_t)(f32_Kp*Q16_ONE) ;
+	i16_KiTs_nom = (int16_t)(f32_Ki*CONTROLLER_TIMESTEP*Q16_ONE) ;
+	i32_R_mV_per_A = (int32_t)(f32_R*1000.0+0.5) ;
+	u16_DB_g_q8 = (uint16_t)(f32_g*256.0+0.5) ;
+	u16_DB_age_q12 = (uint16_t)(f32_age*4096.0+0.5) ;
+	u16_REF_a_q15 = (uint16_t)(f32_a*32768.0+0.5) ;
+	u16_REF_as_q15 = (uint16_t)(f32_as*32768.0+0.5) ;
+	#else
+	Kp = f32_Kp ;
+	Ki = f32_Ki ;
+	f32_DB_g = f32_g ;
+	f32_DB_age = f32_age ;
+	f32_REF_a = f32_a ;
+	f32_REF_as = f32_as ;
+	#endif
+	SREG = sreg;
+}
+
+float controller_get_R(void)
+{
+	return f32_motor_R ;
+}
+
+float controller_get_L(void)
+{
+	return f32_motor_L ;
+}
+
+#ifdef CURRENT_LOOP_FIXED_POINT
 void controller(volatile ModuleValues_t *vals){
 	
-	static float f32_DutyCycleCmd = 50.0 ;
-	float f32_CurrentDelta = 0.0 ;
-	static uint8_t b_saturation = 0;
-	int8_t i8_throttle_cmd = 0;
+	static int32_t i32_DutyCycleCmd = DUTY_Q16(50) ;
+	int16_t i16_Current = 0 ;
+	static ControlType_t last_ctrl_type = CURRENT ;
+	int16_t i16_Cmd = current_cmd_q8(vals) ;
+	uint16_t u16_duty_q8 = 0;
+	int32_t i32_FF = 0 ;
+	int16_t i16_Kp = 0 ;
+	int16_t i16_KiTs = 0 ;
+	uint16_t u16_gain_q8 = 0 ;
+	int16_t i16_Setpoint = i16_Cmd ;
 	
-	if (vals->motor_status == BRAKE)
+	if (vals->ctrl_type == CURRENT || vals->ctrl_type == DEADBEAT)
 	{
-		i8_throttle_cmd = -(int8_t)vals->u8_brake_cmd ;
+		i16_Current = (int16_t)(((int32_t)vals->i16_motor_current*8389) >> 15) ; // mA to Q8.8 A (*256/1000)
+		
+		if (last_ctrl_type == PWM) // the reference model starts from the current
+		{
+			i16_Ref = i16_Current ;
+			i16_RefCmd = i16_Current ;
+		}
+		
+		u16_gain_q8 = gain_schedule_q8(vals->u16_batt_volt) ; // constant bandwidth over the battery voltage range
+		i16_Kp = pid_sat16(((int32_t)i16_Kp_nom*u16_gain_q8) >> 8) ;
+		i16_KiTs = pid_sat16(((int32_t)i16_KiTs_nom*u16_gain_q8) >> 8) ;
+		
+		if (vals->ctrl_type == DEADBEAT)
+		{
+			// one step ahead : steady state duty cycle of the command, plus a/(1-a) times the current still to reach.
+			// Currents are handled as their R.I share of the duty cycle. The present current is the steady state
+			// current of the applied duty cycle, plus what is left of the distance to it at the last sample.
+			// The PI is left with its integral, which trims the model error.
+			int16_t i16_Sample = (int16_t)(((int32_t)vals->i16_motor_current_sample*8389) >> 15) ; // Q8.8 A
+			int32_t i32_Applied = i32_DutyCycleCmd - DUTY_Q16(50) - i32_FF_emf ;
+			int32_t i32_SampleRI = ((i32_FF_r_per_A >> 4)*i16_Sample) >> 4 ;
+			int32_t i32_PresentRI = i32_Applied + ((((i32_SampleRI - i32_Applied) >> 8)*u16_DB_age_q12) >> 4) ;
+			i32_FF = model_duty_q16(i16_Cmd) + (((ri_duty_q16(i16_Cmd) - i32_PresentRI) >> 8)*u16_DB_g_q8) ;
+			i16_Kp = 0 ;
+			i16_Setpoint = i16_RefCmd ; // the last command, reached at this sample
+		}else{
+			#ifdef CURRENT_LOOP_FEEDFORWARD
+			// the feed forward follows the command. The measurement lags it : the PI acts on the error to the reference
+			// model at the sample, that is on the model error only (no kick of the integral on a command step)
+			i32_FF = model_duty_q16(i16_Cmd) ;
+			i16_Setpoint = i16_RefCmd + (int16_t)(((int32_t)pid_sat16((int32_t)i16_Ref - i16_RefCmd)*u16_REF_as_q15) >> 15) ;
+			#endif
+		}
+		
+		if (last_ctrl_type == PWM) // bumpless transfer : the loop starts from the duty cycle applied in PWM mode
+		{
+			pid_track(&current_pid, i32_DutyCycleCmd);
+		}
+		pid_set_gains(&current_pid, i16_Kp, i16_KiTs);
+		i32_DutyCycleCmd = pid_update(&current_pid, i16_Setpoint, i16_Current, i32_FF + DUTY_Q16(50)) ;
+		
+		// reference model : the current the motor model reaches with the past commands, within what the duty cycle gives
+		i16_Ref = i16_RefCmd + (int16_t)(((int32_t)pid_sat16((int32_t)i16_Ref - i16_RefCmd)*u16_REF_a_q15) >> 15) ;
+		i16_RefCmd = i16_Cmd ;
+		if (i16_RefCmd > i16_RefMax)
+		{
+			i16_RefCmd = i16_RefMax ;
+		}
+		if (i16_RefCmd < i16_RefMin)
+		{
+			i16_RefCmd = i16_RefMin ;
+		}
+	
+	}else if (vals->ctrl_type == PWM)
+	{
+		i32_DutyCycleCmd = DUTY_Q16(vals->u8_duty_cycle);
 	}
-	if (vals->motor_status == ACCEL)
+	last_ctrl_type = vals->ctrl_type ;
+	
+	
+	//bounding of duty cycle for well function of bootstrap capacitors
+	if (i32_DutyCycleCmd > DUTY_Q16(95))
 	{
-		i8_throttle_cmd = vals->u8_accel_cmd ;
+		i32_DutyCycleCmd = DUTY_Q16(95);
 	}
 	
-	if (vals->ctrl_type == CURRENT)
+	if (i32_DutyCycleCmd < DUTY_Q16(50))// bounding at 50 to prevent rheostatic braking and backwards motion
 	{
-		if (f32_DutyCycleCmd >= 95 || f32_DutyCycleCmd <= 50)
+		i32_DutyCycleCmd = DUTY_Q16(50);
+	}
+	
+	u16_duty_q8 = (uint16_t)(i32_DutyCycleCmd >> 8) ;
+	
+	if (SW_MODE == BIPOLAR)
+	{
+		OCR3A = (uint16_t)(((uint32_t)u16_duty_q8*OCR_SCALE) >> 24) ; //PWM_PE3 (non inverted)
+		OCR3B = OCR3A ; //PWM_PE4 (inverted)
+		OCR3C = PWM_SAMPLE_POINT_BIPOLAR(OCR3A) ; //motor current sampling point
+	}else{//UNIPOLAR
+		OCR3A = (uint16_t)(((uint32_t)u16_duty_q8*OCR_SCALE) >> 24) ; //PWM_PE3
+		OCR3B = (uint16_t)(((uint32_t)((100 << 8)-u16_duty_q8)*OCR_SCALE) >> 24) ; //PWM_PE4
+	}
+	
+	vals->u8_duty_cycle = (uint8_t)(i32_DutyCycleCmd >> 16) ; //exporting the duty cycle to be able to read in on the CAN and USB
+
+}
+
+#else
+void controller(volatile ModuleValues_t *vals){
+	
+	static float f32_DutyCycleCmd = 50.0 ;
+	float f32_CurrentDelta = 0.0 ;
+	float f32_DutyUnbounded = 0.0 ;
+	static ControlType_t last_ctrl_type = CURRENT ;
+	float f32_Cmd = (float)current_cmd_q8(vals)/256.0 ; // A
+	float f32_FF = 0.0 ;
+	float f32_Prop = 0.0 ;
+	float f32_gain = 1.0 ;
+	
+	if (vals->ctrl_type == CURRENT || vals->ctrl_type == DEADBEAT)
+	{
+		if (last_ctrl_type == PWM) // the reference model starts from the current
+		{
+			f32_Ref = (float)vals->i16_motor_current/1000.0 ;
+			f32_RefCmd = f32_Ref ;
+		}
+		
+		f32_CurrentDelta = (f32_Cmd-(float)vals->i16_motor_current/1000.0)	;
+		f32_gain = (float)gain_schedule_q8(vals->u16_batt_volt)/256.0 ; // constant bandwidth over the battery voltage range
+		
+		if (vals->ctrl_type == DEADBEAT)
 		{
-			b_saturation = 1 ;
-		} else {
-			b_saturation = 0;
+			// one step ahead : steady state duty cycle of the command, plus a/(1-a) times the current still to reach
+			float f32_Applied = f32_DutyCycleCmd - 50.0 - f32_FF_emf ;
+			float f32_SampleRI = f32_FF_r_per_A*(float)vals->i16_motor_current_sample/1000.0 ;
+			float f32_PresentRI = f32_Applied + (f32_SampleRI - f32_Applied)*f32_DB_age ;
+			f32_FF = model_duty(f32_Cmd) ;
+			f32_Prop = (f32_FF_r_per_A*f32_Cmd - f32_PresentRI)*f32_DB_g ;
+			f32_CurrentDelta = (f32_RefCmd-(float)vals->i16_motor_current/1000.0) ; // the last command, reached at this sample
+		}else{
+			#ifdef CURRENT_LOOP_FEEDFORWARD
+			// the feed forward follows the command, the PI acts on the error to the reference model
+			f32_FF = model_duty(f32_Cmd) ;
+			f32_CurrentDelta = (f32_RefCmd + (f32_Ref - f32_RefCmd)*f32_REF_as - (float)vals->i16_motor_current/1000.0) ;
+			#endif
+			f32_Prop = Kp*f32_gain*f32_CurrentDelta ;
 		}
 		
-		f32_CurrentDelta = ((float)(i8_throttle_cmd)-vals->f32_motor_current)	;
+		if (last_ctrl_type == PWM) // bumpless transfer : the loop starts from the duty cycle applied in PWM mode
+		{
+			f32_Integrator = (f32_DutyCycleCmd-50.0-f32_FF-f32_Prop)/Ki ;
+		}else{
+			f32_Integrator+=f32_CurrentDelta*f32_gain*TimeStep ; // scheduled on the increment, as the fixed point integrator
+		}
 		
-		if (!b_saturation) // prevents over integration of an error that cannot be dealt with (because the duty cycle reaches a limit) integral windup protection
+		f32_DutyUnbounded=f32_Prop+f32_Integrator*Ki+f32_FF ;
+		f32_DutyUnbounded=f32_DutyUnbounded+50.0 ;
+		f32_DutyCycleCmd = f32_DutyUnbounded ;
+		if (f32_DutyCycleCmd > 95)
+		{
+			f32_DutyCycleCmd = 95;
+		}
+		if (f32_DutyCycleCmd < 50)
 		{
-			f32_Integrator+=f32_CurrentDelta*TimeStep ;
+			f32_DutyCycleCmd = 50;
 		}
+		// back calculation anti windup : the integrator is pulled back by what the bounds cut off the duty cycle
+		f32_Integrator += (f32_DutyCycleCmd-f32_DutyUnbounded)*KtTs/Ki ;
 		
-		f32_DutyCycleCmd=Kp*f32_CurrentDelta+f32_Integrator*Ki ;
-		f32_DutyCycleCmd=f32_DutyCycleCmd+50.0 ;
+		// reference model : the current the motor model reaches with the past commands, within what the duty cycle gives
+		f32_Ref = f32_RefCmd + (f32_Ref - f32_RefCmd)*f32_REF_a ;
+		f32_RefCmd = f32_Cmd ;
+		if (f32_RefCmd > f32_RefMax)
+		{
+			f32_RefCmd = f32_RefMax ;
+		}
+		if (f32_RefCmd < f32_RefMin)
+		{
+			f32_RefCmd = f32_RefMin ;
+		}
 	
 	}else if (vals->ctrl_type == PWM)
 	{
 		f32_DutyCycleCmd = (float)(vals->u8_duty_cycle);
-		if (vals->f32_motor_current > 0.5)
+		if (vals->i16_motor_current > 500)
 		{
 			//f32_DutyCycleCmd -- ;
 		}
-		if (vals->f32_motor_current < -0.5)
+		if (vals->i16_motor_current < -500)
 		{
 			//f32_DutyCycleCmd ++ ;
 		}
 	}
+	last_ctrl_type = vals->ctrl_type ;
 	
 	
 	//bounding of duty cycle for well function of bootstrap capacitors
@@ -93,6 +497,7 @@ void controller(volatile ModuleValues_t *vals){
 	{
 		OCR3A = (int)((f32_DutyCycleCmd/100.0)*ICR3) ; //PWM_PE3 (non inverted)
 		OCR3B = OCR3A ; //PWM_PE4 (inverted)
+		OCR3C = PWM_SAMPLE_POINT_BIPOLAR(OCR3A) ; //motor current sampling point
 	}else{//UNIPOLAR
 		OCR3A = (int)((f32_DutyCycleCmd/100.0)*ICR3) ; //PWM_PE3
 		OCR3B = (int)(ICR3-(f32_DutyCycleCmd/100.0)*ICR3) ; //PWM_PE4
@@ -101,6 +506,7 @@ void controller(volatile ModuleValues_t *vals){
 	vals->u8_duty_cycle = (uint8_t)f32_DutyCycleCmd ; //exporting the duty cycle to be able to read in on the CAN and USB
 
 }
+#endif
 
 void drivers_init() // defining pin PB4 as logical output
 {
@@ -10,6 +10,7 @@
 #define CONTROLLER_H_
 
 #include <avr/io.h>
+#include "UniversalModuleDrivers/pwm.h"
 #include "pid.h"
 #include "state_machine.h"
 #include "motor_controller_selection.h"
@@ -32,9 +33,75 @@
 #define VOLT_SPEED_CST 77.8.0 //rmp/V
 #endif
 
+//current loop gains, in % of duty cycle per A (Kp) and per A.s (Ki), from the target bandwidth and the motor R and L
+//R and L default to the values above, they are replaced by the commissioning results (see commission.c)
+#define CURRENT_LOOP_BANDWIDTH 736.0 //rad/s, with the duty cycle to voltage gain at CURRENT_LOOP_VBATT_NOM
+#define CURRENT_LOOP_VBATT_NOM 40.0 //V
+#define CURRENT_LOOP_TI_RATIO 13.14 //integral time, in electrical time constants L/R (the loop is far slower than L/R)
+#define KP_FROM_L(l) (CURRENT_LOOP_BANDWIDTH*(l)/(2.0*CURRENT_LOOP_VBATT_NOM/100.0))
+#define KI_FROM_RL(r,l) (KP_FROM_L(l)*(r)/((l)*CURRENT_LOOP_TI_RATIO))
+//gain schedule : the duty cycle to motor voltage gain is proportional to the battery voltage, so Kp and Ki are
+//scaled by CURRENT_LOOP_VBATT_NOM/Vbatt at each step to keep the bandwidth (flash table interpolated in controller.c)
+#define GAIN_SCHEDULE_V0 14336 //mV, first point, below MIN_VOLT (see state_machine.c)
+#define GAIN_SCHEDULE_SHIFT 11 //2048mV between points
+#define GAIN_SCHEDULE_SIZE 22 //last point at 57344mV, above MAX_VOLT
+#define KP_GAIN KP_FROM_L(L) //L*2300*0.4
+#define KI_GAIN KI_FROM_RL(R,L) //R*100*0.7
+//back calculation anti windup : the integrator tracks the bounded duty cycle with a time constant 1/KT_GAIN (s)
+//PWM synchronous : Ti, the integrator then holds the duty cycle at the bound without the P term
+//5ms : 0.4 of the excess per step, a bit slower than Ti (one step), so that the integrator keeps part of its model
+//error correction while saturated and the current does not undershoot on release (see tools/current_loop_sim.c)
+#ifdef CURRENT_LOOP_PWM_SYNC
+#define KT_GAIN (KI_GAIN/KP_GAIN)
+#else
+#define KT_GAIN (0.4/CONTROLLER_TIMESTEP)
+#endif
+#define KT_TIMESTEP ((KT_GAIN*CONTROLLER_TIMESTEP < 1.0) ? (KT_GAIN*CONTROLLER_TIMESTEP) : 1.0)
+
+//feed forward : back-EMF from the motor speed and R.I from the current command
+#define EMF_MV_PER_RPM_Q8 ((int32_t)(1000.0/VOLT_SPEED_CST*256.0))
+
+#ifdef CURRENT_LOOP_PWM_SYNC
+#define CONTROLLER_TIMESTEP (CURRENT_LOOP_PWM_DIVISOR/PWM_FREQ) //every CURRENT_LOOP_PWM_DIVISOR PWM periods (see timer 3 in main.c)
+#else
+#define CONTROLLER_TIMESTEP 0.005 //5ms (see timer 0 in main.c)
+#endif
+
+//control type of ACCEL and BRAKE
+#ifdef CURRENT_LOOP_DEADBEAT
+#define CURRENT_CTRL_TYPE DEADBEAT
+#else
+#define CURRENT_CTRL_TYPE CURRENT
+#endif
+//deadbeat : after one step, the current has a = exp(-Ts.R/L) of its way left to the steady state current of the duty
+//cycle. The gain a/(1-a) on the current still to reach is limited (L/R far longer than the time step).
+//The present current is predicted from the last sample, taken DEADBEAT_SAMPLE_AGE loop steps earlier.
+#define DEADBEAT_GAIN_MAX 8.0
+#ifdef CURRENT_LOOP_PWM_SYNC
+#define DEADBEAT_SAMPLE_AGE ((CURRENT_LOOP_PWM_DIVISOR/2-0.5)/CURRENT_LOOP_PWM_DIVISOR) //sampled half way (see timer 3 in main.c)
+#else
+#define DEADBEAT_SAMPLE_AGE 0.1 //sampled every ms, 0.5ms old on average
+#endif
+
+#ifdef CURRENT_LOOP_PWM_SYNC
+#ifndef CURRENT_LOOP_FIXED_POINT
+#error the float current loop does not fit in the PWM period, define CURRENT_LOOP_FIXED_POINT
+#endif
+#if CURRENT_LOOP_PWM_DIVISOR < 2
+#error CURRENT_LOOP_PWM_DIVISOR must leave at least one PWM period to the other interrupts
+#endif
+//the current loop ISR may use half of its CURRENT_LOOP_PWM_DIVISOR PWM periods, the rest is left to the other interrupts
+//(checked in the timer 3 ISR with timer 1, to SYSTIME_CYCLES_PER_TICK cycles)
+#define CURRENT_LOOP_CYCLE_BUDGET ((uint16_t)(CURRENT_LOOP_PWM_DIVISOR*PWM_PERIOD_CYCLES/2))
+#endif
+
+void controller_set_motor(float f32_R, float f32_L); //winding resistance (ohm) and inductance (H), sets the gains
+float controller_get_R(void);
+float controller_get_L(void);
 void reset_I(void) ;
 void set_I(uint8_t duty) ;
 void controller(volatile ModuleValues_t *vals);
+void controller_feedforward(volatile ModuleValues_t *vals);
 void drivers(uint8_t b_state);
 void drivers_init();
 #endif /* CONTROLLER_H_ */
\ No newline at end of file
@@ -5,57 +5,322 @@
  *  Author: Ultrawack
  */ 
 
+////////////////  DESCRIPTION  ////////////
+/* The maps of motorefficiencies.h give the efficiency (%) of the two motors of the car, motor1 on motor controller 1
+* and motor2 on motor controller 2. They are generated from the dyno data (CSV) by tools/efficiency_map_gen.c :
+* the efficiency at breakpoints of motor speed and torque, closer where the efficiency changes fast, in the flash.
+* efficiency_interp() gives the efficiency at any speed and torque by bilinear interpolation between them.
+* Torque split : the car torque asked by the driver is shared between the two motors for the lowest electrical power,
+* the sum over the motors of (wheel torque share)/efficiency. Both controllers receive the same command and speed,
+* so each one finds the same split and applies its own share. The splits are searched on the computer by
+* tools/torque_split_table_gen.c, for each wheel speed and driver command, into torque_split_table.h :
+* regenerate it when the maps or the constants below change.
+* Online learning : in ACCEL, the electrical power (battery voltage and current of this controller) and the
+* mechanical power (Kt.I.w, with the motor speed estimate) are summed in cells of motor speed and current.
+* Their ratio moves the map towards the measured efficiency, more as the cell gathers energy (LEARN_FULL_J).
+* efficiency_motor(), efficiency_at_current() and efficiency_best_current() use the merged efficiency. The torque
+* split table stays the one of the static maps, the learning gets into it offline : the exported cells (UART
+* EFFICIENCY_EXPORT_UART_CMD) are merged into the dyno CSV by tools/efficiency_learn_merge.c as by merged_efficiency(),
+* then the maps and the table are regenerated and the cells reset (steps in efficiency_learn_merge.c).
+*/
+
 #include "motorefficiencies.h"
+#include "torque_split_table.h"
+#include "efficiency.h"
+#include "speed.h"
+#include "powertrain.h"
 #include <avr/io.h>
-#define MOTOR_ID 1
-#define WHEEL_TO_MOTOR1_RPM 10
-#define WHEEL_TO_MOTOR2_RPM 14
-#define MOTOR_RPM_STEP 50
-#define MOTOR_CURRENT_STEP 1
-#define MAX_TORQUE_M1 1200
-#define STEP_TO_TORQUE 20
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
+#include <avr/eeprom.h>
+#include <stdio.h>
+
+#define STEP_TO_TORQUE 20 // mNm per column of the split table
+#define KT_Q8 ((uint32_t)(MOTOR_SELECT(KT_MOTOR1, KT_MOTOR2)*256.0+0.5)) // this motor
+#define KT_WHEEL ((uint32_t)(KT_MOTOR1*WHEEL_TO_MOTOR1_RPM + KT_MOTOR2*WHEEL_TO_MOTOR2_RPM)) // wheel torque of both motors, mNm/A
+
+#define OWN_MAP MOTOR_SELECT(&motor1, &motor2)
 
+static const EfficiencyMap_t *const maps[] = {&motor1, &motor2} ; // in the order of motorefficiencies.h
+
+const EfficiencyMap_t *efficiency_map(uint8_t u8_motor)
+{
+	return (u8_motor >= 1 && u8_motor <= sizeof(maps)/sizeof(maps[0])) ? maps[u8_motor-1] : 0 ;
+}
 
-uint16_t efficient_gain(uint16_t rpmWheel, uint8_t desired_torque)
+static uint8_t segment(const uint16_t *p_points, uint8_t u8_count, uint16_t u16_x, uint16_t *u16_frac) // breakpoints below x, fraction to the next one in Q8
 {
-	uint16_t motor1_rpm_step = (rpmWheel * WHEEL_TO_MOTOR1_RPM)/MOTOR_RPM_STEP;
-	uint16_t motor2_rpm_step = (rpmWheel * WHEEL_TO_MOTOR2_RPM)/MOTOR_RPM_STEP;
+	uint8_t u8_i = 0 ;
+	uint16_t u16_low = pgm_read_word(&p_points[0]) ;
+	uint16_t u16_high = pgm_read_word(&p_points[1]) ;
 	
-	uint16_t highest_efficiency = 0;
-	uint16_t step_efficiency = 0;
+	if (u16_x <= u16_low)
+	{
+		*u16_frac = 0 ;
+		return 0 ;
+	}
+	while (u16_x >= u16_high)
+	{
+		if (u8_i+2 >= u8_count)
+		{
+			*u16_frac = 256 ; // beyond the map : last point
+			return u8_i ;
+		}
+		u8_i ++ ;
+		u16_low = u16_high ;
+		u16_high = pgm_read_word(&p_points[u8_i+1]) ;
+	}
+	*u16_frac = (uint16_t)(((uint32_t)(u16_x-u16_low) << 8)/(u16_high-u16_low)) ;
+	return u8_i ;
+}
 
-	uint8_t DESIRED_TORQUE_STEP = desired_torque/STEP_TO_TORQUE; //Number of increments until desired torque
+uint8_t efficiency_interp(const EfficiencyMap_t *map, uint16_t u16_rpm, uint16_t u16_torque) // same arithmetic as tools/efficiency_map_gen.c
+{
+	uint16_t u16_fr = 0 ;
+	uint16_t u16_ft = 0 ;
+	uint8_t u8_r = segment(map->p_rpm, map->u8_rpm_points, u16_rpm, &u16_fr) ;
+	uint8_t u8_t = segment(map->p_torque, map->u8_torque_points, u16_torque, &u16_ft) ;
+	const uint8_t *p_low = &map->p_eff[(uint16_t)u8_r*map->u8_torque_points + u8_t] ;
+	const uint8_t *p_high = p_low + map->u8_torque_points ;
+	uint32_t u32_low = (uint32_t)pgm_read_byte(&p_low[0])*(256-u16_ft) + (uint32_t)pgm_read_byte(&p_low[1])*u16_ft ;
+	uint32_t u32_high = (uint32_t)pgm_read_byte(&p_high[0])*(256-u16_ft) + (uint32_t)pgm_read_byte(&p_high[1])*u16_ft ;
 	
-	uint16_t motor1_torque_gain = 0;
-	uint16_t motor2_torque_gain = 0;	
+	return (uint8_t)((u32_low*(256-u16_fr) + u32_high*u16_fr + 32768) >> 16) ;
+}
+
+//////////////// ONLINE LEARNING ////////////////
+
+#define LEARN_MIN_RPM 100 // no mechanical power to compare below
+#define LEARN_MIN_MA 500
+#define LEARN_FULL_UNITS ((uint32_t)(LEARN_FULL_J/(65536.0e-6*0.005))) // electrical sums in 65.536mW over 5ms steps
+#define LEARN_MIN_UNITS 100 // below, the learned efficiency is not computed (no weight anyway)
+#define LEARN_MECH_Q24 ((uint32_t)(MOTOR_SELECT(KT_MOTOR1, KT_MOTOR2)*3.1416/30.0/65536.0*16777216.0+0.5)) // (mA.rpm >> 8) to 65.536mW, Q24
+#define LEARN_SAVE_TICKS ((uint32_t)LEARN_SAVE_PERIOD_S*200) // 5ms steps
+#define LEARN_MAGIC (0xE000 | (LEARN_RPM_CELLS << 4) | LEARN_MA_CELLS) // a saved grid of another size is not loaded
+#define LEARN_CELL_COUNT (LEARN_RPM_CELLS*LEARN_MA_CELLS)
+
+typedef struct
+{
+	uint32_t u32_mech ; // sums of the mechanical and electrical power, in 65.536mW
+	uint32_t u32_elec ;
+} LearnCell_t ;
+
+static LearnCell_t cells[LEARN_RPM_CELLS][LEARN_MA_CELLS] ; // written in the 5ms ISR only
+static EEMEM uint16_t ee_learn_magic ;
+static EEMEM LearnCell_t ee_learn_cells[LEARN_RPM_CELLS][LEARN_MA_CELLS] ;
+
+static uint32_t u32_save_ticks = 0 ;
+static uint8_t b_learned = 0 ; // since the last save
+static volatile uint8_t b_save_pending = 0 ;
+static uint8_t u8_save_cell = 0 ; // background save and export, one cell at a time (see efficiency_learn_handler())
+static uint8_t u8_save_byte = 0 ;
+static LearnCell_t save_copy ;
+static volatile uint8_t b_export_pending = 0 ;
+static uint8_t u8_export_cell = 0 ;
+
+static LearnCell_t read_cell(uint8_t u8_cell) // from the main loop
+{
+	LearnCell_t cell ;
+	uint8_t sreg = SREG;
+	cli();
+	cell = cells[u8_cell/LEARN_MA_CELLS][u8_cell%LEARN_MA_CELLS] ;
+	SREG = sreg;
+	return cell ;
+}
+
+static uint8_t learned_efficiency(LearnCell_t *cell, uint16_t *u16_weight) // %, weight of the learned value in Q8
+{
+	if (cell->u32_elec < LEARN_MIN_UNITS)
+	{
+		*u16_weight = 0 ;
+		return 0 ;
+	}
+	*u16_weight = (cell->u32_elec >= LEARN_FULL_UNITS) ? 256 : (uint16_t)(cell->u32_elec/(LEARN_FULL_UNITS >> 8)) ;
+	uint32_t u32_eff = cell->u32_mech/(cell->u32_elec/100) ;
+	return (u32_eff > 100) ? 100 : (uint8_t)u32_eff ;
+}
+
+static uint8_t merged_efficiency(uint16_t u16_rpm, uint16_t u16_torque) // static map of this motor, moved to the learned value
+{
+	uint8_t u8_static = efficiency_interp(OWN_MAP, u16_rpm, u16_torque) ;
+	uint16_t u16_weight = 0 ;
+	uint16_t u16_row = u16_rpm/LEARN_RPM_CELL ;
+	uint32_t u32_col = (uint32_t)u16_torque*256000UL/KT_Q8/LEARN_MA_CELL ;
+	LearnCell_t *cell = &cells[(u16_row < LEARN_RPM_CELLS) ? u16_row : (LEARN_RPM_CELLS-1)][(u32_col < LEARN_MA_CELLS) ? u32_col : (LEARN_MA_CELLS-1)] ;
+	uint8_t u8_learned = learned_efficiency(cell, &u16_weight) ;
+	return (uint8_t)(((uint16_t)u8_static*(256-u16_weight) + (uint16_t)u8_learned*u16_weight + 128) >> 8) ;
+}
+
+void efficiency_learn_init(void)
+{
+	if (eeprom_read_word(&ee_learn_magic) == LEARN_MAGIC)
+	{
+		eeprom_read_block(cells, ee_learn_cells, sizeof(cells));
+	}
+}
+
+void efficiency_learn(volatile ModuleValues_t *vals) // every 5ms
+{
+	uint16_t u16_rpm = motor_speed_estimate(vals) ;
+	int16_t i16_current = vals->i16_motor_current ;
+	uint8_t b_coupled = (vals->pwtrain_type == BELT || vals->gear_status == GEAR1) ; //motor coupled to the wheel, as in speed_update()
 	
-	for (int TORQUE_STEP = 0; TORQUE_STEP <= DESIRED_TORQUE_STEP; TORQUE_STEP++)
+	if (vals->motor_status == ACCEL && b_coupled && vals->i16_batt_current > 0
+	&& u16_rpm >= LEARN_MIN_RPM && u16_rpm < LEARN_RPM_CELLS*LEARN_RPM_CELL && i16_current >= LEARN_MIN_MA && i16_current < LEARN_MA_CELLS*LEARN_MA_CELL)
+	{
+		LearnCell_t *cell = &cells[u16_rpm/LEARN_RPM_CELL][(uint16_t)i16_current/LEARN_MA_CELL] ;
+		uint32_t u32_elec = ((uint32_t)vals->u16_batt_volt*(uint16_t)vals->i16_batt_current) >> 16 ; // uW to 65.536mW
+		uint32_t u32_mech = ((((uint32_t)i16_current*u16_rpm) >> 8)*LEARN_MECH_Q24) >> 16 ; // Kt.I.w, the friction is not seen
+		if (cell->u32_elec >= 0x80000000UL || cell->u32_mech >= 0x80000000UL) // halved : the old samples weigh less and less, the cell follows the motor ageing
+		{
+			cell->u32_elec >>= 1 ;
+			cell->u32_mech >>= 1 ;
+		}
+		cell->u32_elec += u32_elec ;
+		cell->u32_mech += u32_mech ;
+		b_learned = 1 ;
+	}
+	if (++u32_save_ticks >= LEARN_SAVE_TICKS)
+	{
+		u32_save_ticks = 0 ;
+		if (b_learned)
+		{
+			b_learned = 0 ;
+			b_save_pending = 1 ;
+		}
+	}
+}
+
+void efficiency_learn_reset(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t u8_i = 0; u8_i < LEARN_CELL_COUNT; u8_i++)
+	{
+		cells[u8_i/LEARN_MA_CELLS][u8_i%LEARN_MA_CELLS].u32_mech = 0 ;
+		cells[u8_i/LEARN_MA_CELLS][u8_i%LEARN_MA_CELLS].u32_elec = 0 ;
+	}
+	b_save_pending = 1 ;
+	SREG = sreg;
+}
+
+void efficiency_export_request(void)
+{
+	u8_export_cell = 0 ;
+	b_export_pending = 1 ;
+}
+
+void efficiency_learn_handler(void)
+{
+	// EEPROM : one byte when the EEPROM is ready, so that the main loop is never held (about 3.4ms per byte)
+	if (b_save_pending && eeprom_is_ready())
 	{
-		step_efficiency = motor1[motor1_rpm_step][TORQUE_STEP] + motor2[motor2_rpm_step][DESIRED_TORQUE_STEP-TORQUE_STEP];
-		
-		
-		if (step_efficiency > highest_efficiency)
+		if (u8_save_byte == 0)
 		{
-			highest_efficiency = step_efficiency;
-			motor1_torque_gain = TORQUE_STEP*STEP_TO_TORQUE; //Convert to from step to torque
+			save_copy = read_cell(u8_save_cell) ;
+		}
+		eeprom_update_byte((uint8_t *)&ee_learn_cells[0][0] + (uint16_t)u8_save_cell*sizeof(LearnCell_t) + u8_save_byte, ((uint8_t *)&save_copy)[u8_save_byte]);
+		if (++u8_save_byte == sizeof(LearnCell_t))
+		{
+			u8_save_byte = 0 ;
+			if (++u8_save_cell == LEARN_CELL_COUNT)
+			{
+				u8_save_cell = 0 ;
+				b_save_pending = 0 ;
+				eeprom_update_word(&ee_learn_magic, LEARN_MAGIC); // waits for the last byte
+			}
+		}
+	}
+	// UART : one line per cell, motor rpm and current at the centre of the cell
+	if (b_export_pending)
+	{
+		LearnCell_t cell = read_cell(u8_export_cell) ;
+		uint16_t u16_weight = 0 ;
+		uint8_t u8_learned = learned_efficiency(&cell, &u16_weight) ;
+		uint16_t u16_rpm = (u8_export_cell/LEARN_MA_CELLS)*LEARN_RPM_CELL + LEARN_RPM_CELL/2 ;
+		uint16_t u16_mA = (u8_export_cell%LEARN_MA_CELLS)*LEARN_MA_CELL + LEARN_MA_CELL/2 ;
+		uint16_t u16_torque = (uint16_t)((uint32_t)u16_mA*KT_Q8/256000UL) ;
+		// rpm, mA, learned %, static map %, electrical energy of the cell in J
+		printf("\r\neff,%u,%u,%u,%u,%lu", u16_rpm, u16_mA, u8_learned, efficiency_interp(OWN_MAP, u16_rpm, u16_torque), (uint32_t)(cell.u32_elec*(65536.0e-6*0.005)));
+		if (++u8_export_cell == LEARN_CELL_COUNT)
+		{
+			b_export_pending = 0 ;
+		}
+	}
+}
+
+//////////////// ACCESSORS OF THIS MOTOR ////////////////
 
-			// If distribution of gain exceed limit of M1
-				if (motor1_torque_gain > MAX_TORQUE_M1) {
-					motor1_torque_gain = MAX_TORQUE_M1;
-				}
+uint8_t efficiency_motor(uint16_t u16_rpm, uint16_t u16_torque)
+{
+	return merged_efficiency(u16_rpm, u16_torque) ;
+}
+
+uint8_t efficiency_at_current(uint16_t u16_rpm, uint16_t u16_mA)
+{
+	uint32_t u32_torque = (uint32_t)u16_mA*KT_Q8/256000UL ;
+	return merged_efficiency(u16_rpm, (u32_torque > 0xFFFF) ? 0xFFFF : (uint16_t)u32_torque) ;
+}
 
-			motor2_torque_gain = (DESIRED_TORQUE_STEP-TORQUE_STEP)*STEP_TO_TORQUE; //
+static void best_candidate(uint16_t u16_rpm, uint16_t u16_torque, uint16_t u16_min, uint16_t u16_max, uint16_t *u16_best, uint8_t *u8_best_eff)
+{
+	if (u16_torque > u16_max)
+	{
+		u16_torque = u16_max ;
+	}
+	if (u16_torque > u16_min)
+	{
+		uint8_t u8_eff = merged_efficiency(u16_rpm, u16_torque) ;
+		if (u8_eff >= *u8_best_eff) // the highest torque of a plateau : shorter bursts
+		{
+			*u8_best_eff = u8_eff ;
+			*u16_best = u16_torque ;
 		}
 	}
+}
+
+/* Within a torque segment of the map and a current cell of the learning, the efficiency is linear in torque, so the
+* best one within [min, max] is at a bound, a breakpoint, or either side of a cell edge.
+*/
+uint16_t efficiency_best_current(uint16_t u16_rpm, uint16_t u16_min_mA, uint16_t u16_max_mA)
+{
+	const EfficiencyMap_t *map = OWN_MAP ;
+	uint16_t u16_min = (uint16_t)((uint32_t)u16_min_mA*KT_Q8/256000UL) ;
+	uint16_t u16_max = (uint16_t)((uint32_t)u16_max_mA*KT_Q8/256000UL) ;
+	uint16_t u16_best = u16_min ;
+	uint8_t u8_best_eff = merged_efficiency(u16_rpm, u16_min) ;
 	
-	if (MOTOR_ID == 1)
+	for (uint8_t u8_i = 0; u8_i < map->u8_torque_points; u8_i++)
 	{
-		return motor1_torque_gain;
-	} else if (MOTOR_ID == 2)
+		best_candidate(u16_rpm, pgm_read_word(&map->p_torque[u8_i]), u16_min, u16_max, &u16_best, &u8_best_eff);
+	}
+	for (uint8_t u8_i = 1; u8_i < LEARN_MA_CELLS; u8_i++)
 	{
-		return motor2_torque_gain;
-	} else {
-		return 0x00;
-	}	
-		
-}
\ No newline at end of file
+		uint16_t u16_edge = (uint16_t)(((uint32_t)u8_i*LEARN_MA_CELL*KT_Q8 + 255999UL)/256000UL) ; // first torque of the cell
+		best_candidate(u16_rpm, u16_edge-1, u16_min, u16_max, &u16_best, &u8_best_eff);
+		best_candidate(u16_rpm, u16_edge, u16_min, u16_max, &u16_best, &u8_best_eff);
+	}
+	best_candidate(u16_rpm, u16_max, u16_min, u16_max, &u16_best, &u8_best_eff);
+	return (uint16_t)(((uint32_t)u16_best*256000UL + KT_Q8-1)/KT_Q8) ; // rounded up : efficiency_at_current() finds the same torque
+}
+
+uint16_t efficient_gain(uint16_t u16_wheel_rpm, uint16_t u16_wheel_torque) // wheel torque (mNm) to the torque of this motor (mNm)
+{
+	uint16_t u16_col = (u16_wheel_torque + SPLIT_TORQUE_STEP/2)/SPLIT_TORQUE_STEP ;
+	uint8_t u8_segment = pgm_read_byte(&split_segment[(u16_wheel_rpm < SPLIT_RPM_ROWS) ? u16_wheel_rpm : (SPLIT_RPM_ROWS-1)]) ;
+	uint8_t u8_steps = pgm_read_byte(&MOTOR_SELECT(split_motor1, split_motor2)[u8_segment][(u16_col < SPLIT_CMD_COLS) ? u16_col : (SPLIT_CMD_COLS-1)]) ;
+	return (u8_steps == SPLIT_NONE) ? EFFICIENCY_NO_SPLIT : (uint16_t)u8_steps*STEP_TO_TORQUE ;
+}
+
+void torque_command(volatile ModuleValues_t *vals) // every 5ms
+{
+	uint32_t u32_wheel_torque = (uint32_t)vals->u8_accel_cmd*KT_WHEEL ; // both controllers at the command : a column of the table
+	uint16_t u16_torque = efficient_gain(wheel_speed_rpm(vals), (u32_wheel_torque > 0xFFFE) ? 0xFFFE : (uint16_t)u32_wheel_torque) ;
+	
+	if (u16_torque == EFFICIENCY_NO_SPLIT)
+	{
+		vals->u16_accel_current = (uint16_t)vals->u8_accel_cmd*1000 ; // the command as it is
+	}else{
+		vals->u16_accel_current = (uint16_t)((uint32_t)u16_torque*256000UL/KT_Q8) ;
+	}
+}
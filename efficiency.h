@@ -9,8 +9,43 @@
 #ifndef EFFICIENCY_H_
 #define EFFICIENCY_H_
 
+#include <avr/io.h>
+#include "motor_controller_selection.h"
+#include "state_machine.h"
 
+// efficiency map of motorefficiencies.h (see tools/efficiency_map_gen.c), all in the flash
+typedef struct
+{
+	const uint16_t *p_rpm ; // breakpoints of motor speed, increasing
+	const uint16_t *p_torque ; // breakpoints of torque in mNm, increasing
+	const uint8_t *p_eff ; // efficiency in %, [rpm][torque]
+	uint8_t u8_rpm_points ;
+	uint8_t u8_torque_points ;
+} EfficiencyMap_t ;
 
+#define EFFICIENCY_NO_SPLIT 0xFFFF
+const EfficiencyMap_t *efficiency_map(uint8_t u8_motor); // motor1, motor2... of the maps, 0 if there is none
+uint8_t efficiency_interp(const EfficiencyMap_t *map, uint16_t u16_rpm, uint16_t u16_torque); // %, motor rpm and torque in mNm, bilinear, the map bounds beyond
+// for the motor of this controller (MOTOR_CONTROLLER_x), the map merged with the learned efficiency (from the 5ms ISR)
+uint8_t efficiency_motor(uint16_t u16_rpm, uint16_t u16_torque); // %, motor rpm and torque in mNm
+uint8_t efficiency_at_current(uint16_t u16_rpm, uint16_t u16_mA); // %, motor rpm and current
+uint16_t efficiency_best_current(uint16_t u16_rpm, uint16_t u16_min_mA, uint16_t u16_max_mA); // mA, most efficient current at the speed within [min, max]
+uint16_t efficient_gain(uint16_t u16_wheel_rpm, uint16_t u16_wheel_torque); // mNm of this motor for the car wheel torque (mNm, rounded to SPLIT_TORQUE_STEP), EFFICIENCY_NO_SPLIT at standstill
+void torque_command(volatile ModuleValues_t *vals); // every 5ms, sets vals->u16_accel_current from the accelerator command (TORQUE_SPLIT)
 
+// online learning of the efficiency of this motor, in cells of motor speed and current (RAM, saved in the EEPROM)
+#define LEARN_RPM_CELL 500 //rpm
+#define LEARN_RPM_CELLS 10
+#define LEARN_MA_CELL 2500 //mA
+#define LEARN_MA_CELLS 8
+#define LEARN_FULL_J 2000 //electrical energy of a cell from which the learned efficiency replaces the map
+#define LEARN_SAVE_PERIOD_S 600 //EEPROM save, when something was learned
+#define EFFICIENCY_EXPORT_UART_CMD 1002 //value to send through UART to print the cells
+#define EFFICIENCY_RESET_UART_CMD 1003 //value to send through UART to forget the learned efficiency
+void efficiency_learn_init(void); // loads the cells saved in the EEPROM
+void efficiency_learn(volatile ModuleValues_t *vals); // every 5ms
+void efficiency_learn_reset(void);
+void efficiency_export_request(void);
+void efficiency_learn_handler(void); // in the main loop : EEPROM save and UART export, in the background
 
 #endif /* EFFICIENCY_H_ */
\ No newline at end of file
@@ -0,0 +1,268 @@
+/*
+ * energy.c
+ *
+ * Created: 12/05/2018 11:03:05
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : not hardware specific
+ */ 
+
+#include "energy.h"
+#include "systime.h"
+#include "motor_controller_selection.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define PJ_PER_MWH 3600000000000LL // 1mWh = 3.6J
+#define PJ_PER_J 1000000000000LL
+#define NC_PER_MAH 3600000000LL // 1mAh = 3.6C
+#define MAX_TIME_STEP_US 50000 // longer gaps (start up, SPI stalled) are not integrated, see the 32bit deltas
+#define POWER_SHIFT 16 // power of the deltas in 65.536mW, well below the battery current ADC step (~1W)
+#define LAP_TICKS_PER_S 200 // energy_lap_tick() every 5ms
+
+static volatile int64_t i64_energy_pJ = 0 ;
+static volatile int64_t i64_regen_pJ = 0 ;
+static volatile int64_t i64_charge_nC = 0 ;
+static volatile int64_t i64_regen_nC = 0 ;
+static volatile uint64_t u64_time_us = 0 ; //integration time
+static volatile int32_t i32_peak_power_uW = 0 ;
+
+//32bit deltas since the last energy_fold(), from the SPI interrupt : energy in 65.536nJ (65.536mW.us), charge in nC.
+//Full scale power or current (int16) fills them in 65ms : 5ms between two folds, plus one gap of MAX_TIME_STEP_US.
+static volatile int32_t i32_delta_E = 0 ;
+static volatile int32_t i32_delta_regen_E = 0 ;
+static volatile int32_t i32_delta_Q = 0 ;
+static volatile int32_t i32_delta_regen_Q = 0 ;
+static volatile uint16_t u16_delta_time_us = 0 ;
+
+static uint32_t u32_last_sample_us = 0 ;
+static uint8_t b_first_sample = 1 ;
+
+//laps, updated by energy_lap_tick()
+static int64_t i64_lap_start_pJ = 0 ;
+static uint32_t u32_lap_start_mm = 0 ;
+static uint32_t u32_lap_ticks[ENERGY_LAP_MODES] ; //time spent in each driving mode
+static volatile uint8_t b_lap_request = 0 ;
+static volatile uint16_t u16_lap_count = 0 ;
+static volatile int32_t i32_lap_J = 0 ;
+static volatile uint16_t u16_lap_s = 0 ;
+static volatile uint16_t u16_lap_m = 0 ;
+static volatile uint8_t u8_lap_mode = 0 ;
+
+void energy_init(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	i64_energy_pJ = 0 ;
+	i64_regen_pJ = 0 ;
+	i64_charge_nC = 0 ;
+	i64_regen_nC = 0 ;
+	u64_time_us = 0 ;
+	i32_peak_power_uW = 0 ;
+	i32_delta_E = 0 ;
+	i32_delta_regen_E = 0 ;
+	i32_delta_Q = 0 ;
+	i32_delta_regen_Q = 0 ;
+	u16_delta_time_us = 0 ;
+	b_first_sample = 1 ;
+	SREG = sreg;
+}
+
+void energy_update(uint16_t u16_batt_volt, int16_t i16_batt_current) // in the SPI interrupt : 32bit only
+{
+	uint32_t u32_now = systime_us() ;
+	uint32_t u32_dt = u32_now - u32_last_sample_us ;
+	u32_last_sample_us = u32_now ;
+	
+	if (b_first_sample || u32_dt > MAX_TIME_STEP_US)
+	{
+		b_first_sample = 0 ;
+		return ;
+	}
+	
+	int32_t i32_power_uW = (int32_t)u16_batt_volt*i16_batt_current ; // mV*mA, fits in 31 bits up to 60V and 32A
+	int16_t i16_power = (int16_t)((i32_power_uW + (1L << (POWER_SHIFT-1))) >> POWER_SHIFT) ; // rounded, 65.536mW
+	int32_t i32_dE = (int32_t)i16_power*(uint16_t)u32_dt ;
+	int32_t i32_dQ = (int32_t)i16_batt_current*(uint16_t)u32_dt ;
+	
+	i32_delta_E += i32_dE ;
+	i32_delta_Q += i32_dQ ;
+	if (i32_power_uW < 0)
+	{
+		i32_delta_regen_E -= i32_dE ;
+		i32_delta_regen_Q -= i32_dQ ;
+	}
+	if (i32_power_uW > i32_peak_power_uW)
+	{
+		i32_peak_power_uW = i32_power_uW ;
+	}
+	u16_delta_time_us += (uint16_t)u32_dt ;
+}
+
+void energy_fold(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	int32_t i32_dE = i32_delta_E ;
+	int32_t i32_dregen_E = i32_delta_regen_E ;
+	int32_t i32_dQ = i32_delta_Q ;
+	int32_t i32_dregen_Q = i32_delta_regen_Q ;
+	uint16_t u16_dt = u16_delta_time_us ;
+	i32_delta_E = 0 ;
+	i32_delta_regen_E = 0 ;
+	i32_delta_Q = 0 ;
+	i32_delta_regen_Q = 0 ;
+	u16_delta_time_us = 0 ;
+	SREG = sreg;
+	
+	//only this function writes the totals, the getters read them with interrupts off
+	sreg = SREG;
+	cli();
+	i64_energy_pJ += (int64_t)i32_dE*(1L << POWER_SHIFT) ;
+	i64_regen_pJ += (int64_t)i32_dregen_E*(1L << POWER_SHIFT) ;
+	i64_charge_nC += i32_dQ ;
+	i64_regen_nC += i32_dregen_Q ;
+	u64_time_us += u16_dt ;
+	SREG = sreg;
+}
+
+static int64_t read_atomic(volatile int64_t * p_value)
+{
+	uint8_t sreg = SREG;
+	cli();
+	int64_t i64_value = *p_value ;
+	SREG = sreg;
+	return i64_value ;
+}
+
+int32_t energy_get_mWh(void)
+{
+	return (int32_t)(read_atomic(&i64_energy_pJ)/PJ_PER_MWH) ;
+}
+
+int32_t energy_get_regen_mWh(void)
+{
+	return (int32_t)(read_atomic(&i64_regen_pJ)/PJ_PER_MWH) ;
+}
+
+int32_t energy_get_J(void)
+{
+	return (int32_t)(read_atomic(&i64_energy_pJ)/PJ_PER_J) ;
+}
+
+int32_t energy_get_mAh(void)
+{
+	return (int32_t)(read_atomic(&i64_charge_nC)/NC_PER_MAH) ;
+}
+
+int32_t energy_get_regen_mAh(void)
+{
+	return (int32_t)(read_atomic(&i64_regen_nC)/NC_PER_MAH) ;
+}
+
+int32_t energy_get_peak_power_mW(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	int32_t i32_peak = i32_peak_power_uW ;
+	SREG = sreg;
+	return i32_peak/1000 ;
+}
+
+int32_t energy_get_average_power_mW(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	int64_t i64_energy = i64_energy_pJ ;
+	uint64_t u64_time = u64_time_us ;
+	SREG = sreg;
+	if (u64_time == 0)
+	{
+		return 0 ;
+	}
+	return (int32_t)((i64_energy/(int64_t)u64_time)/1000) ; // pJ/us = uW
+}
+
+void energy_lap_request(void)
+{
+	b_lap_request = 1 ;
+}
+
+void energy_lap_tick(uint8_t u8_mode, uint32_t u32_distance_mm) // from the timer 0 ISR
+{
+	if (u8_mode < ENERGY_LAP_MODES)
+	{
+		u32_lap_ticks[u8_mode] ++ ;
+	}
+	
+	uint32_t u32_lap_mm = u32_distance_mm - u32_lap_start_mm ;
+	#if LAP_DISTANCE_M > 0
+	if (!b_lap_request && u32_lap_mm < LAP_DISTANCE_M*1000UL)
+	#else
+	if (!b_lap_request) // laps ended through UART only (no unsigned compare with 0, -Wtype-limits)
+	#endif
+	{
+		return ;
+	}
+	b_lap_request = 0 ;
+	
+	int64_t i64_energy = read_atomic(&i64_energy_pJ) ;
+	uint32_t u32_ticks = 0 ;
+	uint8_t u8_mode_max = 0 ;
+	for (uint8_t n = 0; n < ENERGY_LAP_MODES; n++)
+	{
+		u32_ticks += u32_lap_ticks[n] ;
+		if (u32_lap_ticks[n] > u32_lap_ticks[u8_mode_max])
+		{
+			u8_mode_max = n ;
+		}
+		u32_lap_ticks[n] = 0 ;
+	}
+	i32_lap_J = (int32_t)((i64_energy - i64_lap_start_pJ)/PJ_PER_J) ;
+	u16_lap_s = (uint16_t)(u32_ticks/LAP_TICKS_PER_S) ;
+	u16_lap_m = (uint16_t)(u32_lap_mm/1000) ;
+	u8_lap_mode = u8_mode_max ;
+	u16_lap_count ++ ;
+	i64_lap_start_pJ = i64_energy ;
+	u32_lap_start_mm = u32_distance_mm ;
+}
+
+uint16_t energy_get_lap_count(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t u16_count = u16_lap_count ;
+	SREG = sreg;
+	return u16_count ;
+}
+
+int32_t energy_get_lap_J(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	int32_t i32_J = i32_lap_J ;
+	SREG = sreg;
+	return i32_J ;
+}
+
+uint16_t energy_get_lap_s(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t u16_s = u16_lap_s ;
+	SREG = sreg;
+	return u16_s ;
+}
+
+uint16_t energy_get_lap_m(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t u16_m = u16_lap_m ;
+	SREG = sreg;
+	return u16_m ;
+}
+
+uint8_t energy_get_lap_mode(void)
+{
+	return u8_lap_mode ;
+}
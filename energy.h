@@ -0,0 +1,43 @@
+/*
+ * energy.h
+ *
+ * Created: 12/05/2018 11:03:17
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : not hardware specific
+ */ 
+
+#ifndef ENERGY_H_
+#define ENERGY_H_
+
+#include <avr/io.h>
+
+// Battery energy and charge accounting, integrated at each battery current sample with the real elapsed time
+// 64bit accumulators : energy in pJ (uW.us), charge in nC (mA.us). Regenerated energy/charge (negative current)
+// is also accumulated on its own. The net values are consumed - regenerated.
+// The samples (SPI interrupt) only add to 32bit deltas, moved to the 64bit totals by energy_fold().
+
+void energy_init(void);
+void energy_update(uint16_t u16_batt_volt, int16_t i16_batt_current); // mV, mA (unfiltered). At each battery sample
+void energy_fold(void); // every 5ms (timer 0), before reading the totals
+
+int32_t energy_get_mWh(void); // net energy
+int32_t energy_get_regen_mWh(void); // regenerated energy (positive)
+int32_t energy_get_J(void); // net energy
+int32_t energy_get_mAh(void); // net charge
+int32_t energy_get_regen_mAh(void); // regenerated charge (positive)
+int32_t energy_get_peak_power_mW(void); // highest power drawn
+int32_t energy_get_average_power_mW(void); // net energy / integration time
+
+// Laps : net energy, time and distance of each lap, and the driving mode used for most of it (see DriveMode_t),
+// to compare the strategies. A lap ends every LAP_DISTANCE_M or on request.
+#define ENERGY_LAP_MODES 3
+#define LAP_UART_CMD 1001 //value to send through UART to end the lap
+void energy_lap_tick(uint8_t u8_mode, uint32_t u32_distance_mm); // every 5ms
+void energy_lap_request(void); // ends the lap at the next tick
+uint16_t energy_get_lap_count(void); // completed laps
+int32_t energy_get_lap_J(void); // last completed lap
+uint16_t energy_get_lap_s(void);
+uint16_t energy_get_lap_m(void);
+uint8_t energy_get_lap_mode(void);
+
+#endif /* ENERGY_H_ */
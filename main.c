@@ -47,6 +47,11 @@
 #include "UniversalModuleDrivers/adc.h"
 #include "UniversalModuleDrivers/uart.h"
 #include "state_machine.h"
+#include "systime.h"
+#include "energy.h"
+#include "commission.h"
+#include "efficiency.h"
+#include "pid_benchmark.h"
 #include "AVR-UART-lib-master/usart.h"
 
 #define USE_USART0
@@ -62,19 +67,16 @@ uint8_t b_select_can_msg = 0;
 //for UART
 uint8_t b_send_uart = 0;
 
-//for SPI
-uint8_t u8_SPI_count = 0; 
+//for the motor current sample and the PWM synchronous current loop
+uint8_t u8_pwm_count = 0;
 
-//for speed
-volatile uint16_t u16_speed_count = 0;
 
-
-void timer1_init_ts(){
-	TCCR1B |= (1<<CS10)|(1<<CS11); // timer 1 prescaler set CLK/64
+void timer1_init_ts(){ // also the 1us time base of systime.c
+	TCCR1B |= (1<<CS11); // timer 1 prescaler set CLK/8
 	TCCR1B |= (1<<WGM12); //CTC
 	TCNT1 = 0; //reset timer value
 	TIMSK1 |= (1<<OCIE1A); //enable interrupt
-	OCR1A = 125; //compare value //every 1ms
+	OCR1A = SYSTIME_TICKS_PER_MS-1; //compare value //every 1ms
 }
 
 void timer0_init_ts(){ 
@@ -85,15 +87,31 @@ void timer0_init_ts(){
 	OCR0A = 39; //compare value // 78 for 10ms, 39 for 5ms, 19 for 2.56ms
 } // => reload time timer 0 = 10ms
 
+void timer3_init_ts(){ // timer 3 is already running as PWM generator (see pwm_init())
+	TIFR3 |= (1<<TOV3)|(1<<OCF3C); //clear flags
+	#ifdef CURRENT_LOOP_PWM_SYNC
+	TIMSK3 |= (1<<TOIE3); //enable overflow interrupt, once per PWM period
+	#endif
+	//otherwise the overflow interrupt is enabled once per ms by timer 1, for the motor current sample
+}
+
+void arm_current_sample(){ // the motor current is read on the next compare match C (see pwm.h)
+	TIFR3 |= (1<<OCF3C)|(1<<ICF3); //clear flags, ICF3 : TOP reached (late sample check)
+	TIMSK3 |= (1<<OCIE3C);
+}
+
 volatile ModuleValues_t ComValues = {
-	.f32_motor_current = 0.0,
-	.f32_batt_current = 0.0,
-	.f32_batt_volt = 0.0,
-	.f32_energy = 0.0,
+	.i16_motor_current = 0,
+	.i16_motor_current_sample = 0,
+	.i16_batt_current = 0,
+	.u16_batt_volt = 0,
 	.u8_motor_temp = 0,
 	.u16_car_speed = 0,
+	.u16_car_speed_mm_s = 0,
+	.i16_car_accel = 0,
 	.u16_motor_speed = 0,
 	.u8_accel_cmd = 0, //in amps
+	.u16_accel_current = 0,
 	.u8_brake_cmd = 0, //in amps
 	.u8_duty_cycle = 50,
 	.u16_watchdog_can = 0,
@@ -103,8 +121,18 @@ volatile ModuleValues_t ComValues = {
 	.gear_status = NEUTRAL,
 	.gear_required = NEUTRAL,
 	.b_driver_status = 0,
+	.b_speed_synch = 0,
+	.u16_engage_time = 0,
+	.b_commission_request = 0,
 	.ctrl_type = CURRENT,
-	.pwtrain_type = BELT
+	.pwtrain_type = BELT,
+	.u16_ctrl_cycles_max = 0,
+	.u16_ctrl_overruns = 0,
+	.u16_sample_misses = 0,
+	.u16_cruise_speed = 0,
+	.i16_cruise_current = 0,
+	.u16_cruise_band = 0,
+	.b_cruise = 0
 };
 
 int main(void)	
@@ -113,11 +141,14 @@ int main(void)
 	rgbled_init();
 	DWC_init();
 	pwm_init();
-	can_init(0,0);
+	CAN_filters_init(); // dashboard and clutch frames only
 	timer1_init_ts();
 	timer0_init_ts();
 	speed_init();
+	timer3_init_ts();
 	spi_init(DIV_4); // clk at clkio/4 = 2MHz init of SPI for external ADC device
+	SPI_acquisition_init(&ComValues); // conversions are queued in the timer 1 ISR and done by the SPI interrupt
+	energy_init(); // integrated at each battery current conversion
 	
 	//uart_set_FrameFormat(USART_8BIT_DATA|USART_1STOP_BIT|USART_NO_PARITY|USART_ASYNC_MODE); // default settings
 	uart_init(BAUD_CALC(500000)); // 8n1 transmission is set as default
@@ -125,11 +156,13 @@ int main(void)
 	stdin = &uart0_io; // uart0_in and uart0_out are only available if NO_USART_RX or NO_USART_TX is defined
 	drivers_init();
 	drivers(0);
+	commission_init(); // motor R and L of the last commissioning, gains of the current loop
+	efficiency_learn_init(); // learned motor efficiency, saved in the EEPROM
 	sei();
 	
     while (1){
 		
-		handle_can(&ComValues, &rxFrame); //receive CAN
+		handle_can(&ComValues); //receive CAN, all the frames waiting
 		
 		#ifdef ENABLE_UART_TX
 			receive_uart(&ComValues);
@@ -153,12 +186,18 @@ int main(void)
 			send_uart(ComValues);
 			b_send_uart = 0;
 		}
+		
+		commission_handler(); // EEPROM write of the commissioning results
+		efficiency_learn_handler(); // EEPROM save and UART export of the learned efficiency
+		pid_benchmark_handler(); // UART cycle cost of pid_update() per configuration, on request
 	}
 }
 
 
 ISR(TIMER0_COMP_vect){ // every 5ms
+	speed_update(&ComValues); // speed observer : speed sensor periods, clutch encoder and motor current
 	handle_DWC(&ComValues); // sets accel and brake cmds to 0 when shell's telemetry system is triggered
+	energy_fold(); // battery energy and charge of the last samples into the totals (see energy.h)
 	state_handler(&ComValues); // manages the state machine
 	if (systic_counter_fast == 7) // every 41ms
 	{
@@ -176,8 +215,7 @@ ISR(TIMER0_COMP_vect){ // every 5ms
 		{
 			ComValues.u16_watchdog_throttle = 0;
 		}
-		
-		handle_joulemeter(&ComValues.f32_energy, ComValues.f32_batt_current, ComValues.f32_batt_volt, 41) ;	//unprecise, to be corrected	
+
 		systic_counter_fast = 0;
 	} else {
 		systic_counter_fast ++;
@@ -193,6 +231,67 @@ ISR(TIMER0_COMP_vect){ // every 5ms
 }
 
 
+/////////////////////////////////////PWM SYNCHRONOUS TASKS////////////////////////////////
+/* The motor current is sampled where it equals its average over the PWM period : at the phase correct valley
+* (BOTTOM) in UNIPOLAR, at the middle of the on time in BIPOLAR. The overflow interrupt arms compare match C
+* for one sample, and the conversion is started by the match, early enough to make up for the time the
+* MCP3208 takes to sample (see pwm.h).
+*/
+
+ISR(TIMER3_OVF_vect){ // every PWM period in PWM synchronous mode, once per ms otherwise
+	#ifdef CURRENT_LOOP_PWM_SYNC
+	if (u8_pwm_count == CURRENT_LOOP_PWM_DIVISOR/2) // sample half way, fresh current for the next loop
+	{
+		arm_current_sample();
+	}
+	
+	if (u8_pwm_count == CURRENT_LOOP_PWM_DIVISOR-1) // every CURRENT_LOOP_PWM_DIVISOR PWM periods
+	{
+		uint16_t u16_start = TCNT1 ;
+		if (ComValues.motor_status == ACCEL || ComValues.motor_status == BRAKE || ComValues.motor_status == ENGAGE)
+		{
+			controller(&ComValues);
+		}
+		
+		//cycle budget check, timed with timer 1 at CLK/8 : SYSTIME_CYCLES_PER_TICK (8) cycles resolution
+		uint16_t u16_cycles = systime_cycles(u16_start) ;
+		if (u16_cycles > ComValues.u16_ctrl_cycles_max)
+		{
+			ComValues.u16_ctrl_cycles_max = u16_cycles ;
+		}
+		if (u16_cycles > CURRENT_LOOP_CYCLE_BUDGET)
+		{
+			ComValues.u16_ctrl_overruns ++ ;
+		}
+		u8_pwm_count = 0;
+	} else {
+		u8_pwm_count ++;
+	}
+	#else
+	arm_current_sample();
+	TIMSK3 &= ~(1<<TOIE3); //one shot, re-enabled by timer 1
+	#endif
+}
+
+ISR(TIMER3_COMPC_vect){ // motor current sampling point
+	uint16_t u16_start = TCNT1 ;
+	uint16_t u16_late = TCNT3 - OCR3C ; //cycles since the match
+	TIMSK3 &= ~(1<<OCIE3C); //one shot
+	if (u16_late > PWM_SAMPLE_WINDOW || (TIFR3 & (1<<ICF3))) //delayed by another ISR, the sample would miss the average
+	{
+		ComValues.u16_sample_misses ++ ;
+		#ifndef CURRENT_LOOP_PWM_SYNC
+		TIFR3 |= (1<<TOV3); //clear flag
+		TIMSK3 |= (1<<TOIE3); //sampled in the next PWM period instead
+		#endif
+		//PWM synchronous : the next loop runs on the previous sample
+	} else {
+		SPI_request(0); //motor current, the other channels are converted after it
+	}
+	systime_isr_cycles(u16_start); //interrupt load (see systime.h)
+}
+
+
 /////////////////////////////////////COMMUNICATION WITH EXTERNAL ADC////////////////////////////////
 /*External ADC HW setup (on Motor Drive V2.0):
 *	CH0 : Motor current
@@ -204,42 +303,17 @@ ISR(TIMER0_COMP_vect){ // every 5ms
 
 ISR(TIMER1_COMPA_vect){// every 1ms
 	
-	if (u16_speed_count < 2000 ) //after 3s with no magnet, speed = 0
-	{
-		u16_speed_count ++ ;
-	} else
-	{
-		ComValues.u16_car_speed = 0;
-		u16_speed_count = 0;
-	}
-	
-	if (u8_SPI_count == 3)
-	{
-		//motor temp
-		SPI_handler_4(&ComValues.u8_motor_temp);
-		u8_SPI_count = 0 ;
-	}
+	uint16_t u16_start = TCNT1 ;
+	systime_tick(); // also ends the interrupt load sum of the last ms
 	
-	if (u8_SPI_count == 2)
-	{
-		//batt volt
-		SPI_handler_2(&ComValues.f32_batt_volt);
-		u8_SPI_count ++ ;
-	}
-	
-	if (u8_SPI_count == 1)
-	{
-		//batt current
-		SPI_handler_1(&ComValues.f32_batt_current);
-		u8_SPI_count ++ ;
-	}	
+	// the motor current is sampled synchronously with the PWM (see timer 3 ISRs)
+	#ifndef CURRENT_LOOP_PWM_SYNC
+	TIFR3 |= (1<<TOV3); //clear flag
+	TIMSK3 |= (1<<TOIE3); //one motor current sample per ms
+	#endif
 	
-	if (u8_SPI_count == 0)
-	{
-		//motor current
-		SPI_handler_0(&ComValues.f32_motor_current);
-		u8_SPI_count ++ ;
-	}
+	SPI_schedule_tick(); // battery current and voltage, motor temperature, converted after the next motor current sample
+	systime_isr_cycles(u16_start); //interrupt load (see systime.h)
 }
 
 
@@ -247,5 +321,5 @@ ISR(INT5_vect) //interrupt on rising front of the speed sensor (each time a magn
 {
 	//rgbled_toggle(LED_GREEN); //uncomment to test speed sensor mounting. should blink periodically. 
 	//remember to comment the "manage_LED" function
-	handle_speed_sensor(&ComValues.u16_car_speed, &u16_speed_count);
+	handle_speed_sensor(); //time stamp, the speed is computed every 5ms by speed_update()
 }
@@ -23,6 +23,7 @@
 #define SPEED_SENSOR_HALL
 // SPEED_SENSOR_REED
 #define NUM_MAGNETS 2
+#define SPEED_TIMEOUT_MS 2000 //with no magnet for that long, the speed is 0
 
 //choose the motor you are using
 #define MOTOR_RE50_36V
@@ -38,6 +39,47 @@
 //Transmit is always on and is reliable. 
 //Reception through UART has lead to some unreliabilities and should be deactivated when unused
 #define ENABLE_UART_TX
+
+//Current loop arithmetic. The fixed point (Q16.16) loop gives the same duty cycle as the float loop
+//within one OCR3 count (tools/current_loop_sim.c). The longest controller() call of each build is in the UART
+//telemetry (u16_ctrl_cycles_max). Comment out to use the float loop.
+#define CURRENT_LOOP_FIXED_POINT
+
+//Current loop feed forward. The back-EMF (motor speed) and the R.I drop of the current command, divided by the
+//battery voltage, are added to the PI output. The PI then only corrects the model error. Comment out for a pure PI.
+#define CURRENT_LOOP_FEEDFORWARD
+
+//Current control in ACCEL and BRAKE. With CURRENT_LOOP_DEADBEAT the duty cycle is predicted from the motor model
+//(R, L, back-EMF, battery voltage) to reach the current command at the next loop step, with a slow integral trim
+//of the model error. Comment out for the PI (with or without feed forward).
+// CURRENT_LOOP_DEADBEAT
+
+//Current loop timing. By default the current loop runs from the state machine every 5ms (timer 0).
+//With CURRENT_LOOP_PWM_SYNC it runs from the timer 3 overflow, every CURRENT_LOOP_PWM_DIVISOR PWM periods.
+// CURRENT_LOOP_PWM_SYNC
+#define CURRENT_LOOP_PWM_DIVISOR 8
+
+//External ADC acquisition. By default the SPI transfers are interrupt driven. SPI_ACQUISITION_BLOCKING busy waits on
+//each transfer inside the ISR that starts it, as before, to compare the interrupt load in the UART telemetry.
+// SPI_ACQUISITION_BLOCKING
+
+//Gear engagement. With ENGAGE_CLOSED_LOOP_SYNCH the duty cycle in ENGAGE is corrected every 5ms from the clutch
+//encoder speed, and the clutch is told when the motor is synchronised. Comment out for the open loop duty cycle.
+#define ENGAGE_CLOSED_LOOP_SYNCH
+
+//Accelerator command. With TORQUE_SPLIT the car torque of both motor controllers at the commanded current is shared
+//between the two motors for the lowest electrical power (efficiency maps, see efficiency.c), each controller applies
+//its share. Both controllers have to be programmed with it. Comment out to apply the commanded current.
+// TORQUE_SPLIT
+
+//Cruise control from the steering wheel. With DASHBOARD_CRUISE_BYTES, bytes 4 and 5 of the dashboard frame are the
+//cruise control target and the pulse and glide speed band in km/h (see CAN_dashboard_handler()). Only with a dashboard
+//firmware that sends them : the frame may be longer for other reasons. Without it, cruise control is set through UART.
+// DASHBOARD_CRUISE_BYTES
+
+//Lap energy logging (see energy.c). A lap ends every LAP_DISTANCE_M meters measured by the wheel speed sensor,
+//and when LAP_UART_CMD is received through UART. 0 : the laps are only ended through UART.
+#define LAP_DISTANCE_M 0
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 //  for MC
@@ -1,201 +1,59 @@
 /*
  * motorefficiencies.h
  *
- * Created: 14.04.2017 12:13:40
- *  Author: Ultrawack
- */ 
-
+ * Generated by tools/efficiency_map_gen.c, do not edit.
+ * motor1 : motor1_efficiency.csv, 16 x 11 points kept of 99 x 61, interpolation error 1.0 % max
+ * motor2 : motor2_efficiency.csv, 15 x 14 points kept of 75 x 101, interpolation error 1.0 % max
+ */
 
 #ifndef MOTOREFFICIENCIES_H_
 #define MOTOREFFICIENCIES_H_
 
 #include <avr/pgmspace.h>
 #include <avr/io.h>
-
-const unsigned char PROGMEM motor1[61][99] = {
-
-	{0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
-	{0,58,56,50,45,40,36,33,31,28,26,25,23,22,21,19,18,18,17,16,15,15,14,14,13,13,12,12,12,11,11,11,10,10,10,9,9,9,9,9,8,8,8,8,8,8,7,7,7,7,7,7,7,7,6,6,6,6,6,6,6},
-	{0,65,68,65,60,56,53,49,46,44,41,39,37,35,34,32,31,30,29,28,27,26,25,24,23,23,22,21,21,20,20,19,19,18,18,17,17,17,16,16,16,15,15,15,14,14,14,14,13,13,13,13,12,12,12,12,12,11,11,11,11},
-	{0,68,73,71,68,65,62,59,56,53,51,49,47,45,43,42,40,39,37,36,35,34,33,32,31,30,30,29,28,27,27,26,26,25,24,24,23,23,22,22,22,21,21,20,20,20,19,19,19,18,18,18,17,17,17,17,16,16,16,16,16},
-	{0,69,76,75,73,70,68,65,62,60,58,56,54,52,50,49,47,46,44,43,42,41,40,39,38,37,36,35,34,33,33,32,31,31,30,29,29,28,28,27,27,26,26,25,25,25,24,24,23,23,23,22,22,22,21,21,21,21,20,20,20},
-	{0,70,78,78,76,74,72,69,67,65,63,61,59,57,56,54,52,51,50,48,47,46,45,44,43,42,41,40,39,38,38,37,36,36,35,34,34,33,32,32,31,31,30,30,29,29,28,28,28,27,27,26,26,26,25,25,25,24,24,24,23},
-	{0,71,79,80,79,77,75,73,71,69,67,65,63,61,60,58,57,55,54,53,52,51,49,48,47,46,45,45,44,43,42,41,40,40,39,38,38,37,37,36,35,35,34,34,33,33,32,32,31,31,31,30,30,29,29,29,28,28,28,27,27},
-	{0,71,80,81,80,79,77,75,73,72,70,68,66,65,63,62,60,59,58,57,55,54,53,52,51,50,49,48,47,47,46,45,44,43,43,42,41,41,40,40,39,38,38,37,37,36,36,35,35,34,34,33,33,33,32,32,31,31,31,30,30},
-	{0,72,81,82,82,80,79,77,76,74,72,71,69,68,66,65,63,62,61,60,59,57,56,55,54,53,52,52,51,50,49,48,47,47,46,45,45,44,43,43,42,42,41,40,40,39,39,38,38,37,37,36,36,36,35,35,34,34,34,33,33},
-	{0,72,82,83,83,82,80,79,77,76,74,73,71,70,69,67,66,65,64,62,61,60,59,58,57,56,55,54,54,53,52,51,50,50,49,48,47,47,46,46,45,44,44,43,43,42,42,41,41,40,40,39,39,38,38,37,37,37,36,36,35},
-	{0,72,82,84,84,83,82,80,79,77,76,75,73,72,71,69,68,67,66,65,64,63,62,61,60,59,58,57,56,55,54,54,53,52,51,51,50,49,49,48,48,47,46,46,45,45,44,44,43,43,42,42,41,41,40,40,39,39,39,38,38},
-	{0,72,82,84,84,84,83,81,80,79,78,76,75,74,72,71,70,69,68,67,66,65,64,63,62,61,60,59,58,58,57,56,55,54,54,53,52,52,51,50,50,49,49,48,48,47,46,46,45,45,44,44,44,43,43,42,42,41,41,40,40},
-	{0,72,83,85,85,84,84,82,81,80,79,78,76,75,74,73,72,71,70,69,68,67,66,65,64,63,62,61,60,60,59,58,57,57,56,55,55,54,53,53,52,51,51,50,50,49,49,48,48,47,47,46,46,45,45,44,44,43,43,43,42},
-	{0,73,83,85,86,85,84,83,82,81,80,79,78,76,75,74,73,72,71,70,69,68,67,66,66,65,64,63,62,61,61,60,59,58,58,57,56,56,55,55,54,53,53,52,52,51,51,50,50,49,49,48,48,47,47,46,46,45,45,45,44},
-	{0,73,83,86,86,86,85,84,83,82,81,80,79,78,77,76,75,74,73,72,71,70,69,68,67,66,65,65,64,63,62,62,61,60,60,59,58,58,57,56,56,55,55,54,53,53,52,52,51,51,50,50,49,49,48,48,48,47,47,46,46},
-	{0,73,83,86,86,86,86,85,84,83,82,81,80,79,78,77,76,75,74,73,72,71,70,69,69,68,67,66,65,65,64,63,62,62,61,60,60,59,59,58,57,57,56,56,55,55,54,54,53,53,52,52,51,51,50,50,49,49,48,48,48},
-	{0,73,84,86,87,87,86,85,84,84,83,82,81,80,79,78,77,76,75,74,73,72,71,71,70,69,68,68,67,66,65,65,64,63,63,62,61,61,60,59,59,58,58,57,57,56,56,55,55,54,54,53,53,52,52,51,51,50,50,50,49},
-	{0,73,84,86,87,87,87,86,85,84,83,82,81,80,80,79,78,77,76,75,74,73,73,72,71,70,70,69,68,67,67,66,65,65,64,63,63,62,61,61,60,60,59,59,58,58,57,57,56,56,55,55,54,54,53,53,52,52,52,51,51},
-	{0,73,84,87,87,87,87,86,86,85,84,83,82,81,80,79,79,78,77,76,75,74,74,73,72,71,71,70,69,69,68,67,67,66,65,65,64,63,63,62,62,61,61,60,59,59,58,58,57,57,56,56,56,55,55,54,54,53,53,53,52},
-	{0,73,84,87,88,88,87,87,86,85,84,84,83,82,81,80,79,79,78,77,76,75,75,74,73,72,72,71,70,70,69,68,68,67,66,66,65,65,64,63,63,62,62,61,61,60,60,59,59,58,58,57,57,56,56,56,55,55,54,54,53},
-	{0,73,84,87,88,88,88,87,86,86,85,84,83,83,82,81,80,79,79,78,77,76,76,75,74,73,73,72,71,71,70,69,69,68,67,67,66,66,65,65,64,63,63,62,62,61,61,60,60,59,59,59,58,58,57,57,56,56,55,55,55},
-	{0,73,84,87,88,88,88,87,87,86,85,85,84,83,82,82,81,80,79,79,78,77,76,76,75,74,74,73,72,72,71,70,70,69,68,68,67,67,66,66,65,65,64,64,63,63,62,62,61,61,60,60,59,59,58,58,57,57,57,56,56},
-	{0,73,84,87,88,88,88,88,87,87,86,85,84,84,83,82,81,81,80,79,79,78,77,76,76,75,74,74,73,72,72,71,71,70,69,69,68,68,67,67,66,66,65,65,64,64,63,63,62,62,61,61,60,60,59,59,59,58,58,57,57},
-	{0,73,84,87,88,89,89,88,88,87,86,86,85,84,83,83,82,81,81,80,79,78,78,77,76,76,75,75,74,73,73,72,71,71,70,70,69,69,68,68,67,67,66,66,65,65,64,64,63,63,62,62,61,61,60,60,60,59,59,58,58},
-	{0,73,85,88,89,89,89,88,88,87,87,86,85,85,84,83,83,82,81,80,80,79,78,78,77,77,76,75,75,74,73,73,72,72,71,71,70,70,69,68,68,67,67,66,66,66,65,65,64,64,63,63,62,62,61,61,61,60,60,59,59},
-	{0,73,85,88,89,89,89,89,88,88,87,86,86,85,84,84,83,82,82,81,80,80,79,78,78,77,77,76,75,75,74,74,73,73,72,71,71,70,70,69,69,68,68,67,67,66,66,65,65,65,64,64,63,63,62,62,62,61,61,60,60},
-	{0,73,85,88,89,89,89,89,88,88,87,87,86,85,85,84,84,83,82,82,81,80,80,79,78,78,77,77,76,75,75,74,74,73,73,72,72,71,71,70,70,69,69,68,68,67,67,66,66,65,65,65,64,64,63,63,62,62,62,61,61},
-	{0,73,85,88,89,89,89,89,89,88,88,87,86,86,85,85,84,83,83,82,81,81,80,80,79,78,78,77,77,76,76,75,74,74,73,73,72,72,71,71,70,70,69,69,68,68,68,67,67,66,66,65,65,65,64,64,63,63,63,62,62},
-	{0,73,85,88,89,90,90,89,89,88,88,87,87,86,86,85,84,84,83,83,82,81,81,80,80,79,78,78,77,77,76,76,75,75,74,74,73,73,72,72,71,71,70,70,69,69,68,68,67,67,67,66,66,65,65,65,64,64,63,63,63},
-	{0,73,85,88,89,90,90,89,89,89,88,88,87,87,86,85,85,84,84,83,82,82,81,81,80,80,79,78,78,77,77,76,76,75,75,74,74,73,73,72,72,71,71,70,70,69,69,69,68,68,67,67,67,66,66,65,65,65,64,64,63},
-	{0,73,85,88,89,90,90,90,89,89,88,88,87,87,86,86,85,85,84,83,83,82,82,81,81,80,79,79,78,78,77,77,76,76,75,75,74,74,73,73,72,72,72,71,71,70,70,69,69,68,68,68,67,67,66,66,66,65,65,65,64},
-	{0,73,85,88,90,90,90,90,90,89,89,88,88,87,87,86,85,85,84,84,83,83,82,82,81,80,80,79,79,78,78,77,77,76,76,75,75,74,74,74,73,73,72,72,71,71,70,70,70,69,69,68,68,68,67,67,66,66,66,65,65},
-	{0,73,85,88,90,90,90,90,90,89,89,88,88,87,87,86,86,85,85,84,84,83,83,82,81,81,80,80,79,79,78,78,77,77,76,76,75,75,75,74,74,73,73,72,72,71,71,71,70,70,69,69,69,68,68,67,67,67,66,66,66},
-	{0,73,85,88,90,90,90,90,90,90,89,89,88,88,87,87,86,86,85,85,84,83,83,82,82,81,81,80,80,79,79,78,78,77,77,76,76,76,75,75,74,74,73,73,72,72,72,71,71,70,70,70,69,69,68,68,68,67,67,67,66},
-	{0,73,85,88,90,90,90,90,90,90,89,89,88,88,87,87,86,86,85,85,84,84,83,83,82,82,81,81,80,80,79,79,78,78,77,77,77,76,76,75,75,74,74,73,73,73,72,72,71,71,71,70,70,69,69,69,68,68,68,67,67},
-	{0,74,85,89,90,90,91,90,90,90,89,89,89,88,88,87,87,86,86,85,85,84,84,83,83,82,82,81,81,80,80,79,79,78,78,77,77,77,76,76,75,75,74,74,74,73,73,72,72,72,71,71,70,70,70,69,69,69,68,68,68},
-	{0,74,85,89,90,90,91,91,90,90,90,89,89,88,88,87,87,86,86,85,85,84,84,83,83,83,82,82,81,81,80,80,79,79,78,78,77,77,77,76,76,75,75,74,74,74,73,73,73,72,72,71,71,71,70,70,70,69,69,68,68},
-	{0,74,85,89,90,91,91,91,90,90,90,89,89,89,88,88,87,87,86,86,85,85,84,84,83,83,82,82,81,81,81,80,80,79,79,78,78,77,77,77,76,76,75,75,75,74,74,73,73,73,72,72,72,71,71,70,70,70,69,69,69},
-	{0,74,85,89,90,91,91,91,91,90,90,90,89,89,88,88,87,87,86,86,86,85,85,84,84,83,83,82,82,81,81,80,80,80,79,79,78,78,77,77,77,76,76,75,75,75,74,74,74,73,73,72,72,72,71,71,71,70,70,70,69},
-	{0,74,85,89,90,91,91,91,91,90,90,90,89,89,89,88,88,87,87,86,86,85,85,84,84,84,83,83,82,82,81,81,80,80,80,79,79,78,78,77,77,77,76,76,76,75,75,74,74,74,73,73,73,72,72,71,71,71,70,70,70},
-	{0,74,85,89,90,91,91,91,91,91,90,90,90,89,89,88,88,87,87,87,86,86,85,85,84,84,83,83,83,82,82,81,81,80,80,80,79,79,78,78,78,77,77,76,76,76,75,75,74,74,74,73,73,73,72,72,72,71,71,71,70},
-	{0,74,85,89,90,91,91,91,91,91,90,90,90,89,89,88,88,88,87,87,86,86,85,85,85,84,84,83,83,82,82,82,81,81,80,80,79,79,79,78,78,78,77,77,76,76,76,75,75,75,74,74,73,73,73,72,72,72,71,71,71},
-	{0,74,85,89,90,91,91,91,91,91,91,90,90,89,89,89,88,88,87,87,87,86,86,85,85,84,84,84,83,83,82,82,81,81,81,80,80,79,79,79,78,78,78,77,77,76,76,76,75,75,75,74,74,74,73,73,73,72,72,72,71},
-	{0,74,85,89,90,91,91,91,91,91,91,90,90,90,89,89,88,88,88,87,87,86,86,86,85,85,84,84,83,83,83,82,82,81,81,81,80,80,79,79,79,78,78,78,77,77,76,76,76,75,75,75,74,74,74,73,73,73,72,72,72},
-	{0,74,85,89,90,91,91,91,91,91,91,90,90,90,89,89,89,88,88,87,87,87,86,86,85,85,85,84,84,83,83,82,82,82,81,81,81,80,80,79,79,79,78,78,78,77,77,76,76,76,75,75,75,74,74,74,73,73,73,72,72},
-	{0,74,85,89,90,91,91,91,91,91,91,91,90,90,90,89,89,88,88,88,87,87,86,86,86,85,85,84,84,84,83,83,82,82,82,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,75,75,75,74,74,74,74,73,73,73},
-	{0,74,85,89,90,91,91,92,91,91,91,91,90,90,90,89,89,89,88,88,87,87,87,86,86,85,85,85,84,84,83,83,83,82,82,82,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,75,74,74,74,73,73},
-	{0,74,85,89,91,91,92,92,92,91,91,91,91,90,90,90,89,89,88,88,88,87,87,86,86,86,85,85,84,84,84,83,83,83,82,82,81,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,75,74,74,74,73},
-	{0,74,85,89,91,91,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,87,87,87,86,86,85,85,85,84,84,84,83,83,82,82,82,81,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,75,74,74,74},
-	{0,74,85,89,91,91,92,92,92,92,91,91,91,90,90,90,89,89,89,88,88,88,87,87,86,86,86,85,85,85,84,84,83,83,83,82,82,82,81,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,75,74,74},
-	{0,74,86,89,91,91,92,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,87,87,87,86,86,86,85,85,84,84,84,83,83,83,82,82,82,81,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,75,75},
-	{0,74,86,89,91,91,92,92,92,92,92,91,91,91,90,90,90,89,89,89,88,88,88,87,87,86,86,86,85,85,85,84,84,84,83,83,83,82,82,82,81,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,75},
-	{0,74,86,89,91,91,92,92,92,92,92,91,91,91,91,90,90,90,89,89,88,88,88,87,87,87,86,86,86,85,85,85,84,84,83,83,83,82,82,82,81,81,81,80,80,80,79,79,79,79,78,78,78,77,77,77,76,76,76,76,75},
-	{0,74,86,89,91,92,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,88,87,87,87,86,86,85,85,85,84,84,84,83,83,83,82,82,82,81,81,81,80,80,80,79,79,79,79,78,78,78,77,77,77,76,76,76,76},
-	{0,74,86,89,91,92,92,92,92,92,92,92,91,91,91,90,90,90,89,89,89,88,88,88,87,87,87,86,86,86,85,85,85,84,84,84,83,83,83,82,82,82,81,81,81,80,80,80,79,79,79,79,78,78,78,77,77,77,76,76,76},
-	{0,74,86,89,91,92,92,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,88,87,87,87,86,86,86,85,85,85,84,84,84,83,83,83,82,82,82,81,81,81,80,80,80,79,79,79,79,78,78,78,77,77,77,76,76},
-	{0,74,86,89,91,92,92,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,88,87,87,87,86,86,86,85,85,85,84,84,84,83,83,83,82,82,82,82,81,81,81,80,80,80,79,79,79,79,78,78,78,77,77,77,77},
-	{0,74,86,89,91,92,92,92,92,92,92,92,92,91,91,91,90,90,90,90,89,89,89,88,88,88,87,87,87,86,86,86,85,85,85,84,84,84,83,83,83,82,82,82,81,81,81,81,80,80,80,79,79,79,78,78,78,78,77,77,77},
-	{0,74,86,89,91,92,92,92,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,88,87,87,87,86,86,86,85,85,85,84,84,84,84,83,83,83,82,82,82,81,81,81,81,80,80,80,79,79,79,78,78,78,78,77,77},
-	{0,74,86,89,91,92,92,92,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,89,88,88,88,87,87,87,86,86,86,85,85,85,84,84,84,83,83,83,83,82,82,82,81,81,81,80,80,80,80,79,79,79,78,78,78,78,77},
-	{0,74,86,89,91,92,92,92,92,92,92,92,92,92,91,91,91,90,90,90,90,89,89,89,88,88,88,87,87,87,86,86,86,85,85,85,85,84,84,84,83,83,83,82,82,82,82,81,81,81,80,80,80,80,79,79,79,78,78,78,78},
-	{0,74,86,89,91,92,92,92,92,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,88,88,87,87,87,86,86,86,85,85,85,84,84,84,84,83,83,83,82,82,82,82,81,81,81,80,80,80,80,79,79,79,78,78,78},
-	{0,74,86,89,91,92,92,92,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,88,88,88,87,87,87,86,86,86,86,85,85,85,84,84,84,83,83,83,83,82,82,82,81,81,81,81,80,80,80,80,79,79,79,78,78},
-	{0,74,86,89,91,92,92,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,88,88,88,88,87,87,87,86,86,86,85,85,85,85,84,84,84,83,83,83,83,82,82,82,81,81,81,81,80,80,80,80,79,79,79,78},
-	{0,74,86,89,91,92,92,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,89,88,88,88,87,87,87,86,86,86,86,85,85,85,84,84,84,84,83,83,83,82,82,82,82,81,81,81,81,80,80,80,79,79,79,79},
-	{0,74,86,89,91,92,92,93,93,93,93,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,88,88,88,88,87,87,87,86,86,86,85,85,85,85,84,84,84,83,83,83,83,82,82,82,82,81,81,81,80,80,80,80,79,79,79},
-	{0,74,86,89,91,92,92,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,89,88,88,88,87,87,87,86,86,86,86,85,85,85,85,84,84,84,83,83,83,83,82,82,82,82,81,81,81,80,80,80,80,79,79},
-	{0,74,86,89,91,92,92,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,88,88,88,88,87,87,87,86,86,86,86,85,85,85,84,84,84,84,83,83,83,83,82,82,82,81,81,81,81,80,80,80,80,79},
-	{0,74,86,89,91,92,92,93,93,93,93,93,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,88,88,88,88,87,87,87,87,86,86,86,85,85,85,85,84,84,84,83,83,83,83,82,82,82,82,81,81,81,81,80,80,80,80},
-	{0,74,86,89,91,92,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,89,89,89,89,88,88,88,87,87,87,87,86,86,86,86,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,81,81,81,81,80,80,80},
-	{0,74,86,90,91,92,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,88,88,88,88,87,87,87,87,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,81,81,81,81,80,80},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,82,82,82,82,81,81,81,81,81,80},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,88,88,88,88,87,87,87,87,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,81,81,81,81,80},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,81,81,81,81},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,81,81,81},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,82,81,81},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,81,81},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82,81},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,83,82,82,82,82},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,86,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,82,82,82,82},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,92,92,92,92,91,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,84,83,83,83,83,82,82,82},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,83,83,83,83,83,82,82},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,89,89,89,89,89,88,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,85,84,84,84,84,83,83,83,83,83,82},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,87,86,86,86,86,85,85,85,85,84,84,84,84,84,83,83,83,83,82},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,93,92,92,92,92,91,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,88,87,87,87,87,86,86,86,86,85,85,85,85,85,84,84,84,84,83,83,83,83,83},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,90,89,89,89,89,88,88,88,88,87,87,87,87,87,86,86,86,86,85,85,85,85,85,84,84,84,84,83,83,83,83},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,89,89,89,89,88,88,88,88,88,87,87,87,87,86,86,86,86,86,85,85,85,85,84,84,84,84,84,83,83,83},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,89,89,89,89,89,88,88,88,88,87,87,87,87,87,86,86,86,86,85,85,85,85,85,84,84,84,84,84,83,83},
-	{0,74,86,90,91,92,93,93,93,93,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,90,89,89,89,89,88,88,88,88,88,87,87,87,87,86,86,86,86,86,85,85,85,85,84,84,84,84,84,83,83},
-	{0,74,86,90,91,92,93,93,93,94,93,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,89,89,89,89,89,88,88,88,88,87,87,87,87,87,86,86,86,86,85,85,85,85,85,84,84,84,84,84,83},
-	{0,74,86,90,92,92,93,93,93,94,94,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,90,89,89,89,89,88,88,88,88,88,87,87,87,87,86,86,86,86,86,85,85,85,85,85,84,84,84,84,84},
-	{0,74,86,90,92,92,93,93,93,94,94,94,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,90,90,90,90,90,89,89,89,89,89,88,88,88,88,87,87,87,87,87,86,86,86,86,86,85,85,85,85,84,84,84,84,84},
-	{0,74,86,90,92,92,93,93,94,94,94,94,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,89,89,89,89,89,88,88,88,88,88,87,87,87,87,86,86,86,86,86,85,85,85,85,85,84,84,84,84},
-	{0,74,86,90,92,93,93,93,94,94,94,94,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,90,89,89,89,89,88,88,88,88,88,87,87,87,87,87,86,86,86,86,86,85,85,85,85,85,84,84,84},
-	{0,74,86,90,92,93,93,93,94,94,94,94,94,93,93,93,93,93,93,92,92,92,92,92,92,91,91,91,91,90,90,90,90,90,89,89,89,89,89,88,88,88,88,88,87,87,87,87,86,86,86,86,86,85,85,85,85,85,84,84,84},
-	{0,74,86,90,92,93,93,93,94,94,94,94,94,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,90,89,89,89,89,88,88,88,88,88,87,87,87,87,87,86,86,86,86,86,85,85,85,85,85,84,84},
-	{0,74,86,90,92,93,93,93,94,94,94,94,94,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,90,89,89,89,89,89,88,88,88,88,88,87,87,87,87,87,86,86,86,86,85,85,85,85,85,85,84},
-	{0,74,86,90,92,93,93,93,94,94,94,94,94,94,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,90,89,89,89,89,89,88,88,88,88,88,87,87,87,87,87,86,86,86,86,86,85,85,85,85,85,84},
-	{0,74,86,90,92,93,93,93,94,94,94,94,94,94,93,93,93,93,93,93,93,92,92,92,92,92,91,91,91,91,91,90,90,90,90,90,89,89,89,89,89,88,88,88,88,88,87,87,87,87,87,86,86,86,86,86,85,85,85,85,85},
-
-
+#include "efficiency.h"
+
+const uint16_t PROGMEM motor1_rpm[16] = {0,50,100,150,250,350,500,750,950,1300,1750,2300,2950,3550,4450,4900};
+const uint16_t PROGMEM motor1_torque[11] = {0,20,40,60,100,180,300,420,620,860,1200}; // mNm
+const uint8_t PROGMEM motor1_eff[16][11] = { // efficiency in %, [rpm][torque]
+	{0,0,0,0,0,0,0,0,0,0,0},
+	{0,58,56,50,40,28,19,15,11,8,6},
+	{0,65,68,65,56,44,32,26,19,15,11},
+	{0,68,73,71,65,53,42,34,26,20,16},
+	{0,70,78,78,74,65,54,46,37,30,23},
+	{0,71,80,81,79,72,62,54,45,37,30},
+	{0,72,82,84,83,77,69,63,54,46,38},
+	{0,73,83,86,86,83,77,71,63,56,48},
+	{0,73,84,87,88,85,80,75,68,61,53},
+	{0,73,85,88,89,88,84,80,74,68,61},
+	{0,74,85,89,90,90,87,84,79,74,68},
+	{0,74,85,89,91,91,89,87,83,79,73},
+	{0,74,86,89,92,92,91,89,86,82,77},
+	{0,74,86,90,92,93,92,90,88,85,80},
+	{0,74,86,90,92,94,93,92,90,87,83},
+	{0,74,86,90,93,94,93,92,90,88,85}
 };
-
-const unsigned char PROGMEM motor2[101][75] = {
-
-	{0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
-	{0,21,49,55,56,54,53,51,49,47,45,43,42,40,39,37,36,35,34,33,32,31,30,29,28,27,27,26,25,25,24,24,23,23,22,22,21,21,20,20,20,19,19,19,18,18,18,17,17,17,16,16,16,16,15,15,15,15,15,14,14,14,14,14,13,13,13,13,13,13,12,12,12,12,12,12,12,11,11,11,11,11,11,11,11,10,10,10,10,10,10,10,10,10,10,10,9,9,9,9,9},
-	{0,22,54,62,64,65,64,63,62,61,59,58,57,55,54,53,51,50,49,48,47,46,45,44,43,42,41,41,40,39,38,38,37,36,36,35,34,34,33,33,32,32,31,31,30,30,29,29,29,28,28,28,27,27,26,26,26,25,25,25,25,24,24,24,23,23,23,23,22,22,22,22,21,21,21,21,21,20,20,20,20,20,19,19,19,19,19,19,18,18,18,18,18,18,17,17,17,17,17,17,17},
-	{0,23,55,64,68,69,69,69,68,67,66,65,64,63,62,61,60,59,58,57,56,55,54,53,52,51,51,50,49,48,47,47,46,45,45,44,44,43,42,42,41,41,40,40,39,39,38,38,37,37,36,36,35,35,35,34,34,34,33,33,32,32,32,31,31,31,31,30,30,30,29,29,29,29,28,28,28,28,27,27,27,27,26,26,26,26,25,25,25,25,25,24,24,24,24,24,23,23,23,23,23},
-	{0,23,56,66,70,71,72,72,72,71,70,70,69,68,67,66,65,64,63,63,62,61,60,59,58,58,57,56,55,55,54,53,53,52,51,51,50,49,49,48,48,47,47,46,46,45,45,44,44,43,43,42,42,42,41,41,40,40,40,39,39,38,38,38,37,37,37,36,36,36,35,35,35,35,34,34,34,33,33,33,33,32,32,32,32,31,31,31,31,30,30,30,30,30,29,29,29,29,28,28,28},
-	{0,23,56,67,71,73,74,74,74,74,73,73,72,71,70,70,69,68,67,67,66,65,64,64,63,62,61,61,60,59,59,58,57,57,56,56,55,55,54,53,53,52,52,51,51,50,50,49,49,48,48,48,47,47,46,46,45,45,45,44,44,44,43,43,42,42,42,41,41,41,40,40,40,39,39,39,39,38,38,38,37,37,37,37,36,36,36,36,35,35,35,35,34,34,34,34,34,33,33,33,33},
-	{0,23,57,67,72,74,75,76,76,75,75,75,74,74,73,72,72,71,70,70,69,68,68,67,66,66,65,64,64,63,62,62,61,61,60,60,59,58,58,57,57,56,56,55,55,54,54,53,53,53,52,52,51,51,50,50,50,49,49,48,48,48,47,47,47,46,46,46,45,45,45,44,44,44,43,43,43,42,42,42,42,41,41,41,40,40,40,40,39,39,39,39,38,38,38,38,38,37,37,37,37},
-	{0,23,57,68,72,75,76,77,77,77,77,76,76,75,75,74,74,73,73,72,71,71,70,70,69,68,68,67,67,66,65,65,64,64,63,63,62,62,61,61,60,60,59,59,58,58,57,57,56,56,56,55,55,54,54,54,53,53,52,52,52,51,51,51,50,50,50,49,49,49,48,48,48,47,47,47,46,46,46,45,45,45,45,44,44,44,43,43,43,43,42,42,42,42,41,41,41,41,41,40,40},
-	{0,23,57,68,73,75,77,77,78,78,78,77,77,77,76,76,75,75,74,74,73,73,72,72,71,71,70,69,69,68,68,67,67,66,66,65,65,64,64,63,63,62,62,62,61,61,60,60,59,59,59,58,58,57,57,57,56,56,55,55,55,54,54,54,53,53,53,52,52,52,51,51,51,50,50,50,49,49,49,49,48,48,48,47,47,47,47,46,46,46,46,45,45,45,45,44,44,44,44,43,43},
-	{0,23,57,68,73,76,77,78,78,79,79,78,78,78,78,77,77,76,76,75,75,74,74,73,73,72,72,71,71,70,70,69,69,68,68,67,67,67,66,66,65,65,64,64,63,63,63,62,62,61,61,61,60,60,59,59,59,58,58,58,57,57,57,56,56,56,55,55,55,54,54,54,53,53,53,52,52,52,52,51,51,51,50,50,50,50,49,49,49,49,48,48,48,48,47,47,47,47,46,46,46},
-	{0,23,57,68,73,76,78,79,79,79,79,79,79,79,79,78,78,77,77,77,76,76,75,75,74,74,73,73,72,72,72,71,71,70,70,69,69,68,68,68,67,67,66,66,65,65,65,64,64,64,63,63,62,62,62,61,61,61,60,60,60,59,59,59,58,58,58,57,57,57,56,56,56,55,55,55,55,54,54,54,53,53,53,53,52,52,52,51,51,51,51,50,50,50,50,50,49,49,49,49,48},
-	{0,23,58,69,74,76,78,79,80,80,80,80,80,80,79,79,79,78,78,78,77,77,76,76,76,75,75,74,74,73,73,73,72,72,71,71,70,70,70,69,69,68,68,68,67,67,66,66,66,65,65,65,64,64,64,63,63,63,62,62,62,61,61,61,60,60,60,59,59,59,58,58,58,57,57,57,57,56,56,56,56,55,55,55,54,54,54,54,53,53,53,53,52,52,52,52,51,51,51,51,51},
-	{0,23,58,69,74,77,78,79,80,80,80,80,80,80,80,80,80,79,79,79,78,78,77,77,77,76,76,75,75,75,74,74,73,73,73,72,72,71,71,71,70,70,70,69,69,68,68,68,67,67,67,66,66,66,65,65,65,64,64,64,63,63,63,62,62,62,61,61,61,61,60,60,60,59,59,59,59,58,58,58,57,57,57,57,56,56,56,56,55,55,55,55,54,54,54,54,53,53,53,53,53},
-	{0,23,58,69,74,77,79,80,80,81,81,81,81,81,81,80,80,80,80,79,79,79,78,78,78,77,77,76,76,76,75,75,75,74,74,73,73,73,72,72,72,71,71,71,70,70,69,69,69,68,68,68,67,67,67,66,66,66,65,65,65,65,64,64,64,63,63,63,62,62,62,62,61,61,61,61,60,60,60,59,59,59,59,58,58,58,58,57,57,57,57,56,56,56,56,55,55,55,55,55,54},
-	{0,23,58,69,74,77,79,80,81,81,81,81,81,81,81,81,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,74,74,74,73,73,73,72,72,72,71,71,71,70,70,70,69,69,69,68,68,68,67,67,67,67,66,66,66,65,65,65,65,64,64,64,63,63,63,63,62,62,62,62,61,61,61,60,60,60,60,59,59,59,59,59,58,58,58,58,57,57,57,57,56,56,56},
-	{0,23,58,69,74,77,79,80,81,81,82,82,82,82,82,81,81,81,81,81,80,80,80,79,79,79,78,78,78,77,77,77,76,76,76,75,75,75,74,74,74,73,73,73,72,72,72,72,71,71,71,70,70,70,69,69,69,68,68,68,68,67,67,67,66,66,66,66,65,65,65,64,64,64,64,63,63,63,63,62,62,62,62,61,61,61,61,60,60,60,60,60,59,59,59,59,58,58,58,58,58},
-	{0,23,58,69,74,77,79,80,81,82,82,82,82,82,82,82,82,82,81,81,81,81,80,80,80,79,79,79,78,78,78,78,77,77,77,76,76,76,75,75,75,74,74,74,73,73,73,73,72,72,72,71,71,71,70,70,70,70,69,69,69,68,68,68,68,67,67,67,67,66,66,66,65,65,65,65,64,64,64,64,63,63,63,63,63,62,62,62,62,61,61,61,61,60,60,60,60,60,59,59,59},
-	{0,23,58,69,75,78,79,81,81,82,82,82,82,82,82,82,82,82,82,82,81,81,81,81,80,80,80,79,79,79,79,78,78,78,77,77,77,76,76,76,76,75,75,75,74,74,74,73,73,73,73,72,72,72,71,71,71,71,70,70,70,70,69,69,69,68,68,68,68,67,67,67,67,66,66,66,66,65,65,65,65,64,64,64,64,64,63,63,63,63,62,62,62,62,62,61,61,61,61,60,60},
-	{0,23,58,69,75,78,80,81,82,82,82,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,80,80,80,79,79,79,79,78,78,78,77,77,77,77,76,76,76,75,75,75,75,74,74,74,73,73,73,73,72,72,72,72,71,71,71,70,70,70,70,69,69,69,69,68,68,68,68,67,67,67,67,66,66,66,66,66,65,65,65,65,64,64,64,64,64,63,63,63,63,62,62,62,62,62,61},
-	{0,23,58,69,75,78,80,81,82,82,83,83,83,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,80,80,80,79,79,79,79,78,78,78,78,77,77,77,76,76,76,76,75,75,75,75,74,74,74,73,73,73,73,72,72,72,72,71,71,71,71,70,70,70,70,69,69,69,69,68,68,68,68,68,67,67,67,67,66,66,66,66,65,65,65,65,65,64,64,64,64,64,63,63,63,63,63},
-	{0,23,58,69,75,78,80,81,82,82,83,83,83,83,83,83,83,83,83,83,83,82,82,82,82,81,81,81,81,80,80,80,80,79,79,79,79,78,78,78,78,77,77,77,77,76,76,76,75,75,75,75,74,74,74,74,73,73,73,73,72,72,72,72,71,71,71,71,71,70,70,70,70,69,69,69,69,68,68,68,68,68,67,67,67,67,66,66,66,66,66,65,65,65,65,65,64,64,64,64,64},
-	{0,23,58,69,75,78,80,81,82,83,83,83,83,84,84,84,83,83,83,83,83,83,83,82,82,82,82,81,81,81,81,80,80,80,80,79,79,79,79,78,78,78,78,77,77,77,77,76,76,76,76,75,75,75,75,74,74,74,74,73,73,73,73,72,72,72,72,72,71,71,71,71,70,70,70,70,70,69,69,69,69,68,68,68,68,68,67,67,67,67,67,66,66,66,66,66,65,65,65,65,65},
-	{0,23,58,69,75,78,80,81,82,83,83,83,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,80,80,80,80,79,79,79,79,78,78,78,78,77,77,77,77,77,76,76,76,76,75,75,75,75,74,74,74,74,73,73,73,73,73,72,72,72,72,71,71,71,71,71,70,70,70,70,69,69,69,69,69,68,68,68,68,68,67,67,67,67,67,66,66,66,66,66,65},
-	{0,23,58,69,75,78,80,81,82,83,83,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,80,80,80,80,79,79,79,79,79,78,78,78,78,77,77,77,77,76,76,76,76,75,75,75,75,75,74,74,74,74,73,73,73,73,73,72,72,72,72,71,71,71,71,71,70,70,70,70,70,69,69,69,69,69,68,68,68,68,68,67,67,67,67,67,67,66},
-	{0,23,58,69,75,78,80,81,82,83,83,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,81,81,81,81,81,80,80,80,80,79,79,79,79,79,78,78,78,78,77,77,77,77,76,76,76,76,76,75,75,75,75,75,74,74,74,74,73,73,73,73,73,72,72,72,72,72,71,71,71,71,71,70,70,70,70,70,69,69,69,69,69,68,68,68,68,68,68,67,67},
-	{0,23,58,70,75,78,80,82,82,83,84,84,84,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,82,82,82,82,82,81,81,81,81,81,80,80,80,80,79,79,79,79,79,78,78,78,78,77,77,77,77,77,76,76,76,76,76,75,75,75,75,74,74,74,74,74,73,73,73,73,73,72,72,72,72,72,71,71,71,71,71,70,70,70,70,70,70,69,69,69,69,69,68,68,68,68},
-	{0,23,58,70,75,78,80,82,83,83,84,84,84,84,84,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,80,80,80,80,80,79,79,79,79,79,78,78,78,78,78,77,77,77,77,76,76,76,76,76,75,75,75,75,75,74,74,74,74,74,73,73,73,73,73,72,72,72,72,72,72,71,71,71,71,71,70,70,70,70,70,69,69,69,69,69,69},
-	{0,23,58,70,75,78,80,82,83,83,84,84,84,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,82,82,82,82,82,81,81,81,81,81,80,80,80,80,80,79,79,79,79,79,78,78,78,78,78,77,77,77,77,77,76,76,76,76,76,75,75,75,75,75,74,74,74,74,74,73,73,73,73,73,72,72,72,72,72,72,71,71,71,71,71,71,70,70,70,70,70,69,69},
-	{0,23,58,70,75,78,80,82,83,83,84,84,84,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,81,80,80,80,80,80,79,79,79,79,79,78,78,78,78,78,77,77,77,77,77,76,76,76,76,76,75,75,75,75,75,75,74,74,74,74,74,73,73,73,73,73,73,72,72,72,72,72,71,71,71,71,71,71,70,70,70,70},
-	{0,23,58,70,75,78,80,82,83,83,84,84,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,82,82,82,82,82,82,81,81,81,81,81,80,80,80,80,80,79,79,79,79,79,78,78,78,78,78,77,77,77,77,77,77,76,76,76,76,76,75,75,75,75,75,75,74,74,74,74,74,73,73,73,73,73,73,72,72,72,72,72,72,71,71,71,71,71,71},
-	{0,23,58,70,75,78,80,82,83,84,84,84,85,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,79,79,79,79,79,78,78,78,78,78,78,77,77,77,77,77,76,76,76,76,76,76,75,75,75,75,75,74,74,74,74,74,74,73,73,73,73,73,73,72,72,72,72,72,72,71,71,71},
-	{0,23,58,70,75,78,81,82,83,84,84,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,79,79,79,79,79,78,78,78,78,78,78,77,77,77,77,77,77,76,76,76,76,76,75,75,75,75,75,75,74,74,74,74,74,74,73,73,73,73,73,73,72,72,72,72,72,72},
-	{0,23,58,70,75,79,81,82,83,84,84,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,82,81,81,81,81,81,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,77,77,77,77,77,77,76,76,76,76,76,76,75,75,75,75,75,75,74,74,74,74,74,74,73,73,73,73,73,73,72,72,72},
-	{0,23,58,70,75,79,81,82,83,84,84,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,78,77,77,77,77,77,76,76,76,76,76,76,76,75,75,75,75,75,75,74,74,74,74,74,74,73,73,73,73,73,73},
-	{0,23,58,70,75,79,81,82,83,84,84,85,85,85,85,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,78,77,77,77,77,77,77,76,76,76,76,76,76,75,75,75,75,75,75,75,74,74,74,74,74,74,73,73,73},
-	{0,23,58,70,75,79,81,82,83,84,84,85,85,85,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,78,77,77,77,77,77,77,76,76,76,76,76,76,76,75,75,75,75,75,75,74,74,74,74,74,74,74},
-	{0,23,58,70,75,79,81,82,83,84,85,85,85,85,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,82,82,82,82,82,82,81,81,81,81,81,81,81,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,78,77,77,77,77,77,77,77,76,76,76,76,76,76,75,75,75,75,75,75,75,74,74,74,74},
-	{0,23,58,70,75,79,81,82,83,84,85,85,85,86,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,78,78,77,77,77,77,77,77,76,76,76,76,76,76,76,75,75,75,75,75,75,75,74},
-	{0,23,58,70,75,79,81,82,83,84,85,85,85,86,86,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,78,78,77,77,77,77,77,77,77,76,76,76,76,76,76,76,75,75,75,75,75},
-	{0,23,58,70,75,79,81,82,83,84,85,85,85,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,81,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,78,78,78,78,78,78,78,77,77,77,77,77,77,77,76,76,76,76,76,76,76,75,75,75},
-	{0,23,58,70,75,79,81,82,83,84,85,85,85,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,81,80,80,80,80,80,80,79,79,79,79,79,79,79,78,78,78,78,78,78,78,77,77,77,77,77,77,77,77,76,76,76,76,76,76,76},
-	{0,23,58,70,75,79,81,82,83,84,85,85,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,79,78,78,78,78,78,78,78,78,77,77,77,77,77,77,77,76,76,76,76,76},
-	{0,23,58,70,75,79,81,82,83,84,85,85,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78,78,78,78,78,77,77,77,77,77,77,77,76,76,76},
-	{0,23,58,70,75,79,81,82,83,84,85,85,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78,78,78,78,78,77,77,77,77,77,77,77,77},
-	{0,23,58,70,75,79,81,82,84,84,85,85,86,86,86,86,86,86,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78,78,78,78,78,77,77,77,77,77,77},
-	{0,23,58,70,76,79,81,82,84,84,85,85,86,86,86,86,86,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78,78,78,78,78,78,77,77,77},
-	{0,23,58,70,76,79,81,82,84,84,85,85,86,86,86,86,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78,78,78,78,78,78,77},
-	{0,23,58,70,76,79,81,83,84,84,85,85,86,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78,78,78,78,78},
-	{0,23,58,70,76,79,81,83,84,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78,78,78},
-	{0,23,58,70,76,79,81,83,84,84,85,86,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78,78,78},
-	{0,23,58,70,76,79,81,83,84,84,85,86,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,79,79,79,79,79,79,79,79,78},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,80,79,79,79,79,79,79,79},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,80,79,79,79,79,79},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,80,79,79,79},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,80,79},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80,80,80},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,80,80,80,80,80,80,80},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,80,80,80,80,80},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,81,80,80,80},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81,81,80},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,87,87,87,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81,81},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,87,87,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81,81,81},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,87,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,81,81,81,81,81,81},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,81,81,81,81,81},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,81,81,81},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82,82,81},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82,82},
-	{0,23,58,70,76,79,81,83,84,85,85,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82,82,82},
-	{0,23,58,70,76,79,81,83,84,85,86,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82,82},
-	{0,23,58,70,76,79,81,83,84,85,86,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,83,82,82,82,82,82,82},
-	{0,23,58,70,76,79,81,83,84,85,86,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,83,82,82,82,82},
-	{0,23,58,70,76,79,81,83,84,85,86,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,83,82,82,82},
-	{0,23,58,70,76,79,81,83,84,85,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,83,83,82},
-	{0,23,58,70,76,79,81,83,84,85,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83,83},
-	{0,23,58,70,76,79,81,83,84,85,86,86,87,87,87,87,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,88,87,87,87,87,87,87,87,87,87,87,87,87,87,86,86,86,86,86,86,86,86,86,86,86,86,85,85,85,85,85,85,85,85,85,85,85,85,84,84,84,84,84,84,84,84,84,84,84,84,83,83,83,83,83,83,83,83,83,83},
-
-
+const EfficiencyMap_t motor1 = {motor1_rpm, motor1_torque, &motor1_eff[0][0], 16, 11};
+
+const uint16_t PROGMEM motor2_rpm[15] = {0,50,100,150,200,250,350,500,700,1000,1300,1750,2350,3100,3700};
+const uint16_t PROGMEM motor2_torque[14] = {0,20,40,60,80,120,180,260,460,680,1000,1360,1840,2000}; // mNm
+const uint8_t PROGMEM motor2_eff[15][14] = { // efficiency in %, [rpm][torque]
+	{0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+	{0,21,49,55,56,53,47,40,29,22,16,13,10,9},
+	{0,22,54,62,64,64,61,55,44,36,28,22,18,17},
+	{0,23,55,64,68,69,67,63,53,45,36,30,24,23},
+	{0,23,56,66,70,72,71,68,59,51,43,36,30,28},
+	{0,23,56,67,71,74,74,71,64,56,48,41,34,33},
+	{0,23,57,68,72,76,77,75,70,63,56,49,42,40},
+	{0,23,57,68,73,78,79,79,75,70,63,57,50,48},
+	{0,23,58,69,74,79,81,81,79,75,69,64,58,56},
+	{0,23,58,69,75,80,82,83,82,79,75,71,65,64},
+	{0,23,58,70,75,80,83,84,84,82,78,75,70,69},
+	{0,23,58,70,75,81,84,85,85,84,82,79,75,74},
+	{0,23,58,70,76,81,84,86,87,86,84,82,79,78},
+	{0,23,58,70,76,81,85,87,88,87,86,84,82,81},
+	{0,23,58,70,76,81,85,87,88,88,87,85,83,83}
 };
+const EfficiencyMap_t motor2 = {motor2_rpm, motor2_torque, &motor2_eff[0][0], 15, 14};
 
 #endif /* MOTOREFFICIENCIES_H_ */
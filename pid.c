@@ -3,44 +3,63 @@
  *
  * Created: 24.03.2017 13:52:07
  *  Author: Jorgen Jackwitz
- */ 
+ */
 
+#include <avr/interrupt.h>
 #include "pid.h"
 
-#define TIMECONSTANT 1000000
-#define GAINCONSTANT 1000
-
-int32_t pid(Pid_t *PID, uint16_t currentValue, uint16_t setpoint){
-	int output = 0;
-
-	PID->totError = setpoint - currentValue;
-	// Proportional gain
-	int propGain = (PID->Kp)*(PID->totError);
-	// Integration gain
-	PID->intError = PID->intError + (PID->timeStep)*(PID->totError);
-	int intGain = PID->intError*(PID->Ki);
-	// Derivation gain
-	PID->derError = (PID->totError - PID->lastError)/(PID->timeStep);
-	int derGain = (PID->derError)*(PID->Kd);
-	PID->lastError = PID->totError;
-	/*
-	printf("totError: %d \t", PID->totError);
-	printf("IntError: %d \t", PID->intError);
-	printf("DerError: %d \t",PID->derError);
-
-	printf("PropGain: %d \t", propGain);
-	printf("IntGain: %d \t", intGain);
-	printf("DerGain: %d \t", derGain);
-	*/
-	// Pid output
-	output = propGain + intGain + derGain;
-	//printf("Out: %d \n", output);
-	return output;
+// configuration and state changes, the step itself is pid_update() (inline, see pid.h)
+
+void pid_init(Pid_t *PID, int16_t i16_Kp, int16_t i16_KiTs, int16_t i16_KdTs, uint16_t u16_KtTs, PidPWeight_t p_weight)
+{
+	PID->i16_Kp = i16_Kp ;
+	PID->i16_KiTs = i16_KiTs ;
+	PID->i16_KdTs = i16_KdTs ;
+	PID->u16_KtTs = (u16_KtTs > PID_KT_ONE) ? PID_KT_ONE : u16_KtTs ;
+	PID->u16_d_filter = PID_FILTER_NONE ;
+	PID->p_weight = p_weight ;
+	PID->i32_out_min = INT32_MIN ;
+	PID->i32_out_max = INT32_MAX ;
+	pid_reset(PID);
+}
+
+void pid_set_limits(Pid_t *PID, int32_t i32_min, int32_t i32_max)
+{
+	PID->i32_out_min = i32_min ;
+	PID->i32_out_max = i32_max ;
+}
+
+void pid_set_filter(Pid_t *PID, uint16_t u16_d_filter)
+{
+	PID->u16_d_filter = u16_d_filter ;
 }
 
-void pid_init(Pid_t *PID, float t, float p, float i, float d){
-	PID->Kp = p;
-	PID->Ki = i;
-	PID->Kd = d;
-	PID->timeStep = t;
-}
\ No newline at end of file
+void pid_reset(Pid_t *PID)
+{
+	uint8_t sreg = SREG;
+	cli(); // the current loop may run from an ISR
+	PID->i32_integrator = 0 ;
+	PID->i32_derivative = 0 ;
+	PID->i16_last_meas = 0 ;
+	PID->b_started = 0 ;
+	PID->b_track = 0 ;
+	SREG = sreg;
+}
+
+void pid_set_integrator(Pid_t *PID, int32_t i32_value)
+{
+	uint8_t sreg = SREG;
+	cli();
+	PID->i32_integrator = i32_value ;
+	PID->b_track = 0 ;
+	SREG = sreg;
+}
+
+void pid_track(Pid_t *PID, int32_t i32_out)
+{
+	uint8_t sreg = SREG;
+	cli();
+	PID->i32_track_out = i32_out ;
+	PID->b_track = 1 ;
+	SREG = sreg;
+}
@@ -3,7 +3,7 @@
  *
  * Created: 5/1/2017 11:37:40 PM
  *  Author: Ole
- */ 
+ */
 
 
 #ifndef PID_H_
@@ -11,23 +11,137 @@
 
 #include <avr/io.h>
 #include <stdint.h>
-#include "UniversalModuleDrivers/usbdb.h"
 
-typedef struct{
+// Fixed point PID, for the current loop (controller.c) and the speed synchronisation (speed.c)
+// term = gain*input >> PID_SHIFT : with inputs in Qn and gains in Qm, the output is in Q(n+m-PID_SHIFT).
+// Gains are 16 bits, so the products never overflow 32 bits. The sums saturate.
+#define PID_SHIFT 8
+#define PID_GAIN(x, q) ((int16_t)((x)*(float)(1L << (q)))) // float gain to Qq, at compile time or in init code
+#define PID_KT_Q 15 // back calculation gain in Q15, PID_KT_ONE clamps the integrator to the output bounds
+#define PID_KT_ONE (1U << PID_KT_Q)
+#define PID_FILTER_NONE 0xFFFF // derivative low pass coefficient (Ts/(Tf+Ts) in Q16), no filtering
+
+typedef enum
+{
+	PID_P_ON_ERROR = 0,
+	PID_P_ON_MEASUREMENT = 1 // setpoint weight 0, when a feed forward follows the setpoint
+} PidPWeight_t ;
 
-	int lastError;
-	int totError;
-	int intError;
-	int derError;
+typedef struct{
+	int16_t i16_Kp ;
+	int16_t i16_KiTs ; // Ki times the time step
+	int16_t i16_KdTs ; // Kd divided by the time step, 0 skips the derivative
+	uint16_t u16_KtTs ; // back calculation anti windup, Q15
+	uint16_t u16_d_filter ; // derivative low pass, Q16
+	PidPWeight_t p_weight ;
+	int32_t i32_out_min ;
+	int32_t i32_out_max ;
 
-	float timeStep;
-	float Kp;
-	float Kd;
-	float Ki;
+	int32_t i32_integrator ; // in output units
+	int32_t i32_derivative ; // filtered derivative term, in output units
+	int16_t i16_last_meas ;
+	uint8_t b_started ; // no derivative on the first step
+	uint8_t b_track ; // bumpless transfer, see pid_track()
+	int32_t i32_track_out ;
 } Pid_t;
 
-void pid_init(Pid_t *PID, float t, float p, float i, float d);
+void pid_init(Pid_t *PID, int16_t i16_Kp, int16_t i16_KiTs, int16_t i16_KdTs, uint16_t u16_KtTs, PidPWeight_t p_weight);
+void pid_set_limits(Pid_t *PID, int32_t i32_min, int32_t i32_max);
+void pid_set_filter(Pid_t *PID, uint16_t u16_d_filter);
+void pid_reset(Pid_t *PID);
+void pid_set_integrator(Pid_t *PID, int32_t i32_value);
+void pid_track(Pid_t *PID, int32_t i32_out); // the next pid_update() returns i32_out (the output applied meanwhile)
+
+//////////////// HOT PATH ////////////////
+
+static inline int32_t pid_sat_add(int32_t a, int32_t b)
+{
+	int32_t s = (int32_t)((uint32_t)a + (uint32_t)b) ;
+	if (((a ^ s) & (b ^ s)) < 0) // both operands of the other sign than the result
+	{
+		s = (a < 0) ? INT32_MIN : INT32_MAX ;
+	}
+	return s ;
+}
+
+static inline int16_t pid_sat16(int32_t x)
+{
+	if (x > INT16_MAX)
+	{
+		return INT16_MAX ;
+	}
+	if (x < -INT16_MAX)
+	{
+		return -INT16_MAX ;
+	}
+	return (int16_t)x ;
+}
+
+static inline int32_t pid_mul(int16_t i16_gain, int16_t i16_x)
+{
+	return ((int32_t)i16_gain*i16_x) >> PID_SHIFT ;
+}
+
+static inline void pid_set_gains(Pid_t *PID, int16_t i16_Kp, int16_t i16_KiTs) // gain scheduling, every step
+{
+	PID->i16_Kp = i16_Kp ;
+	PID->i16_KiTs = i16_KiTs ;
+}
+
+// one step, returns the output bounded to the limits. The feed forward is added before the bounds.
+static inline int32_t pid_update(Pid_t *PID, int16_t i16_setpoint, int16_t i16_meas, int32_t i32_ff)
+{
+	int16_t i16_error = pid_sat16((int32_t)i16_setpoint - i16_meas) ;
+	int32_t i32_prop ;
+	int32_t i32_out ;
+	int32_t i32_unbounded ;
+
+	if (PID->p_weight == PID_P_ON_MEASUREMENT)
+	{
+		i32_prop = -pid_mul(PID->i16_Kp, i16_meas) ;
+	}else{
+		i32_prop = pid_mul(PID->i16_Kp, i16_error) ;
+	}
+
+	if (PID->i16_KdTs != 0) // on the measurement, no kick on setpoint steps
+	{
+		if (PID->b_started)
+		{
+			int32_t i32_raw = -pid_mul(PID->i16_KdTs, pid_sat16((int32_t)i16_meas - PID->i16_last_meas)) ;
+			PID->i32_derivative += ((int32_t)pid_sat16((i32_raw - PID->i32_derivative) >> 8)*(int32_t)PID->u16_d_filter) >> 8 ;
+		}
+		PID->i16_last_meas = i16_meas ;
+	}
+	PID->b_started = 1 ;
+
+	i32_unbounded = pid_sat_add(pid_sat_add(i32_prop, PID->i32_derivative), i32_ff) ;
+	if (PID->b_track)
+	{
+		PID->i32_integrator = PID->i32_track_out - i32_unbounded ;
+		PID->b_track = 0 ;
+	}else{
+		PID->i32_integrator = pid_sat_add(PID->i32_integrator, pid_mul(PID->i16_KiTs, i16_error)) ;
+	}
+	i32_unbounded = pid_sat_add(i32_unbounded, PID->i32_integrator) ;
+
+	i32_out = i32_unbounded ;
+	if (i32_out > PID->i32_out_max)
+	{
+		i32_out = PID->i32_out_max ;
+	}
+	if (i32_out < PID->i32_out_min)
+	{
+		i32_out = PID->i32_out_min ;
+	}
 
-int32_t pid(Pid_t *PID, uint16_t currentValue, uint16_t setpoint);
+	// back calculation : the integrator is pulled back by what the bounds cut off
+	if (PID->u16_KtTs == PID_KT_ONE)
+	{
+		PID->i32_integrator += i32_out - i32_unbounded ;
+	}else{
+		PID->i32_integrator += ((int32_t)pid_sat16((i32_out - i32_unbounded) >> 8)*PID->u16_KtTs) >> (PID_KT_Q-8) ;
+	}
+	return i32_out ;
+}
 
-#endif /* PID_H_ */
\ No newline at end of file
+#endif /* PID_H_ */
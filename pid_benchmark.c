@@ -0,0 +1,100 @@
+/*
+ * pid_benchmark.c
+ *
+ * Created: 20/05/2018 10:41:22
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : not hardware specific
+ */
+
+////////////////  DESCRIPTION  ////////////
+/* CPU cycles of one pid_update() on the target, for each configuration of pid.h, started from IDLE with a UART
+* command (see receive_uart()). PID_BENCH_CALLS calls are timed together with timer 1 (systime_cycles()), interrupts
+* off, minus the same loop calling an empty function : the result is per call, with a 1 cycle resolution.
+* One line per configuration : "pid,<configuration>,<cycles>", configurations :
+* 0 : P
+* 1 : PI, integrator clamped to the bounds (PID_KT_ONE)
+* 2 : PI, back calculation anti windup (current loop, pure PI)
+* 3 : PI, back calculation, P on the measurement
+* 4 : PID, back calculation, unfiltered derivative
+* 5 : PID, back calculation, filtered derivative
+*/
+
+#include "pid_benchmark.h"
+#include "pid.h"
+#include "systime.h"
+#include <stdio.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define PID_BENCH_CALLS 8 // timed together, well below the 1ms wrap of systime_cycles() (interrupts off meanwhile)
+#define PID_BENCH_CONFIGS 6
+#define PID_BENCH_SETPOINT 1000
+#define PID_BENCH_LIMIT (1L << 24) // not reached, the bounds are checked but do not cut
+
+static volatile uint8_t b_bench_pending = 0 ;
+static uint8_t u8_bench_config = 0 ;
+static volatile int32_t i32_bench_sink = 0 ;
+
+// not inlined, so that both timed loops pay the same call
+static int32_t __attribute__((noinline)) bench_update(Pid_t *PID, int16_t i16_meas)
+{
+	return pid_update(PID, PID_BENCH_SETPOINT, i16_meas, 0) ;
+}
+
+static int32_t __attribute__((noinline)) bench_empty(Pid_t *PID, int16_t i16_meas)
+{
+	(void)PID ;
+	return i16_meas ;
+}
+
+static void bench_config(Pid_t *PID, uint8_t u8_config)
+{
+	int16_t i16_KiTs = (u8_config >= 1) ? PID_GAIN(0.01, 16) : 0 ;
+	int16_t i16_KdTs = (u8_config >= 4) ? PID_GAIN(0.1, 16) : 0 ;
+	uint16_t u16_KtTs = (u8_config >= 2) ? PID_KT_ONE/2 : PID_KT_ONE ;
+	PidPWeight_t p_weight = (u8_config == 3) ? PID_P_ON_MEASUREMENT : PID_P_ON_ERROR ;
+	pid_init(PID, PID_GAIN(0.05, 16), i16_KiTs, i16_KdTs, u16_KtTs, p_weight);
+	pid_set_limits(PID, -PID_BENCH_LIMIT, PID_BENCH_LIMIT);
+	if (u8_config == 5)
+	{
+		pid_set_filter(PID, 0x2000);
+	}
+}
+
+static uint16_t bench_time(Pid_t *PID, int32_t (*step)(Pid_t *, int16_t)) // cycles of PID_BENCH_CALLS steps
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t u16_start = TCNT1 ;
+	for (uint8_t n = 0; n < PID_BENCH_CALLS; n++)
+	{
+		i32_bench_sink = step(PID, PID_BENCH_SETPOINT - 100 + ((int16_t)n << 4)) ; // the measurement moves, for the derivative
+	}
+	uint16_t u16_cycles = systime_cycles(u16_start) ;
+	SREG = sreg;
+	return u16_cycles ;
+}
+
+void pid_benchmark_request(void)
+{
+	u8_bench_config = 0 ;
+	b_bench_pending = 1 ;
+}
+
+void pid_benchmark_handler(void)
+{
+	if (!b_bench_pending)
+	{
+		return ;
+	}
+	Pid_t pid ;
+	bench_config(&pid, u8_bench_config) ;
+	bench_update(&pid, PID_BENCH_SETPOINT) ; // first step, no derivative yet
+	uint16_t u16_cycles = bench_time(&pid, bench_update) ;
+	uint16_t u16_base = bench_time(&pid, bench_empty) ;
+	printf("\r\npid,%u,%u", u8_bench_config, (u16_cycles-u16_base)/PID_BENCH_CALLS);
+	if (++u8_bench_config == PID_BENCH_CONFIGS)
+	{
+		b_bench_pending = 0 ;
+	}
+}
@@ -0,0 +1,19 @@
+/*
+ * pid_benchmark.h
+ *
+ * Created: 20/05/2018 10:41:06
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : not hardware specific
+ */
+
+#ifndef PID_BENCHMARK_H_
+#define PID_BENCHMARK_H_
+
+#include <avr/io.h>
+
+#define PID_BENCH_UART_CMD 1004 //value to send through UART to time pid_update() in each configuration, from IDLE
+
+void pid_benchmark_request(void);
+void pid_benchmark_handler(void); // in the main loop : one configuration timed and printed per call
+
+#endif /* PID_BENCHMARK_H_ */
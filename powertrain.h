@@ -0,0 +1,30 @@
+/*
+ * powertrain.h
+ *
+ * Created: 27/05/2018 14:02:36
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : not hardware specific
+ */
+
+#ifndef POWERTRAIN_H_
+#define POWERTRAIN_H_
+
+// Wheel and reductions of the car, shared by the speed computations (speed.c), the torque split (efficiency.c)
+// and the host side tools (tools/torque_split_table_gen.c and tools/efficiency_learn_merge.c include this file :
+// no AVR header here)
+#define D_WHEEL 0.556 // in m
+#define PI 3.14
+#define GEAR_RATIO_1 18.75 //375/24 = 15.6, 375/18 = 20.8
+#define GEAR_RATIO_2 18.75 //200/16 = 12.5  (BELT mode)
+
+// motor rpm per wheel rpm of each motor in the torque split (motor1 on motor controller 1, motor2 on 2)
+// the torque split table is generated in steps of 1/WHEEL_TO_MOTOR_DEN : the ratios have to be multiples of it
+#define WHEEL_TO_MOTOR1_RPM GEAR_RATIO_1
+#define WHEEL_TO_MOTOR2_RPM GEAR_RATIO_1
+#define WHEEL_TO_MOTOR_DEN 4
+
+// torque constants of the motors of the torque split and of their efficiency maps (motorefficiencies.h)
+#define KT_MOTOR1 (60000.0/(2.0*3.1416*158.0)) // mNm/A, RE50 36V
+#define KT_MOTOR2 (60000.0/(2.0*3.1416*77.8)) // mNm/A, RE65 48V
+
+#endif /* POWERTRAIN_H_ */
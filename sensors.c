@@ -7,7 +7,9 @@
  */ 
 
 #include "sensors.h"
+#include "thermistor_table.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <stdio.h>
 
 void DWC_init()
@@ -27,47 +29,67 @@ void handle_DWC(volatile ModuleValues_t *vals)
 	  }
 }
 
-void handle_current_sensor(volatile float *f32_current, uint16_t u16_ADC_reg, uint8_t u8_sensor_num)
+int16_t current_sensor_mA(uint16_t u16_ADC_reg, uint8_t u8_sensor_num) //unfiltered, in mA
 {
-	volatile float f_new_current = ((((volatile float)u16_ADC_reg*5.0/4096.0) - TRANSDUCER_OFFSET)/TRANSDUCER_SENSIBILITY) ;// /3 because current passes 3x in transducer for more precision.
+	int32_t i32_new_current = ((int32_t)u16_ADC_reg*CURRENT_GAIN_Q8) >> 8 ;// /3 because current passes 3x in transducer for more precision.
+	
 	if (u8_sensor_num)
 	{//batt
-		f_new_current = (f_new_current+CORRECTION_OFFSET_BAT);// correction of offset
+		i32_new_current += CURRENT_OFFSET_BAT ;// correction of offset
 	}else{
-		f_new_current = (f_new_current+CORRECTION_OFFSET_MOT);// correction of offset
+		i32_new_current += CURRENT_OFFSET_MOT ;// correction of offset
 	}
 	
-	*f32_current = (*f32_current)*(1-LOWPASS_CONSTANT) + LOWPASS_CONSTANT*f_new_current ;// low pass filter ---------------------TODO test
+	//the transducer range is +-60A, saturating to the int16 range
+	if (i32_new_current > INT16_MAX)
+	{
+		i32_new_current = INT16_MAX ;
+	}
+	if (i32_new_current < -INT16_MAX)
+	{
+		i32_new_current = -INT16_MAX ;
+	}
+	return (int16_t)i32_new_current ;
 }
 
-void handle_temp_sensor(volatile uint8_t *u8_temp, uint16_t u16_ADC_reg)
+void handle_current_sensor(volatile int16_t *i16_current, uint16_t u16_ADC_reg, uint8_t u8_sensor_num) //in mA
 {
-	float f_sens_volt = ((float)u16_ADC_reg*5.0/4096.0);
-	//Thermistors NTC 495-75654-ND
-	// give temp by three linear approxiations : 
-	// 0 -> 3.7V => T = 20*V-22
-	// 3.7 -> 4.7V => T = 55.5*V-155.5
-	// 4.7 -> 5V => T = 220*V-840
-	// this approximation system is used because it requires less processing power and variable accuracy than the 3rd order polyfit. 
-	// Here we approximate the curve by three straight lines
+	int32_t i32_new_current = current_sensor_mA(u16_ADC_reg, u8_sensor_num) ;
+	int16_t i16_filtered = *i16_current ;
 	
-	if (f_sens_volt <= 3.7)
-	{
-		*u8_temp = (uint8_t)(20.0*f_sens_volt-22.0);
+	if (u8_sensor_num)
+	{//batt
+		i16_filtered += (int16_t)((i32_new_current-i16_filtered) >> LOWPASS_SHIFT) ;// low pass filter
+	}else{
+		i16_filtered += (int16_t)((i32_new_current-i16_filtered) >> LOWPASS_SHIFT_MOT) ;// light low pass filter, samples are synchronous with the PWM
 	}
+	*i16_current = i16_filtered ;
+}
+
+void handle_voltage_sensor(volatile uint16_t *u16_volt, uint16_t u16_ADC_reg) //in mV
+{
+	*u16_volt = (uint16_t)((((int32_t)u16_ADC_reg*VOLT_GAIN_Q8) >> 8) + VOLT_OFFSET) ;
+}
+
+void handle_temp_sensor(volatile uint8_t *u8_temp, uint16_t u16_ADC_reg)
+{
+	//Thermistors NTC 495-75654-ND
+	// flash table of the temperature every 64 ADC codes, built from the thermistor Beta model by tools/thermistor_table_gen.c
+	// linear interpolation between two points (less than 1 degC error up to 120 degC)
+	uint8_t u8_index = u16_ADC_reg >> THERMISTOR_INDEX_SHIFT ;
+	uint8_t u8_frac = u16_ADC_reg & ((1 << THERMISTOR_INDEX_SHIFT)-1) ;
+	int16_t i16_t0 = (int16_t)pgm_read_word(&thermistor_table[u8_index]) ;
+	int16_t i16_t1 = (int16_t)pgm_read_word(&thermistor_table[u8_index+1]) ;
+	int16_t i16_temp = i16_t0 + (int16_t)(((int32_t)(i16_t1-i16_t0)*u8_frac) >> THERMISTOR_INDEX_SHIFT) ; // in 1/16 degC
 	
-	if (f_sens_volt <= 4.7 && f_sens_volt > 3.7)
+	i16_temp = (i16_temp + (1 << (THERMISTOR_Q_SHIFT-1))) >> THERMISTOR_Q_SHIFT ; // rounding to degC
+	if (i16_temp < 0)
 	{
-		*u8_temp = (uint8_t)(55.5*f_sens_volt-155.5);
+		i16_temp = 0 ;
 	}
-	
-	if (f_sens_volt > 4.7)
+	if (i16_temp > 255)
 	{
-		*u8_temp = (uint8_t)(200.0*f_sens_volt-840.0);
+		i16_temp = 255 ;
 	}
+	*u8_temp = (uint8_t)i16_temp ;
 }
-
-void handle_joulemeter(volatile float *f32_energy, volatile float f32_bat_current, volatile float f32_bat_voltage, uint8_t u8_time_period) //units : A, V, ms
-{
-	*f32_energy += f32_bat_voltage*f32_bat_current*(float)u8_time_period/1000 ;
-}
\ No newline at end of file
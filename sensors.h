@@ -37,17 +37,27 @@
 #define VOLT_CONVERSION_OFFSET 0.3
 #endif
 
-#define LOWPASS_CONSTANT 0.1
+// low pass filters : new = old + (sample-old)/2^shift
+#define LOWPASS_SHIFT 3 // ~0.1
+#define LOWPASS_SHIFT_MOT 1 // 0.5, the motor current is sampled at its average value (see PWM synchronous sampling in main.c)
 
+// integer calibration, from ADC counts (12bit ADC with Vref = 5V) to mA : mA = (ADC*gain)/256 + offset
+#define CURRENT_GAIN_Q8 ((int32_t)(5.0/4096.0/TRANSDUCER_SENSIBILITY*1000.0*256.0+0.5))
+#define CURRENT_OFFSET_BAT ((int32_t)((CORRECTION_OFFSET_BAT-TRANSDUCER_OFFSET/TRANSDUCER_SENSIBILITY)*1000.0))
+#define CURRENT_OFFSET_MOT ((int32_t)((CORRECTION_OFFSET_MOT-TRANSDUCER_OFFSET/TRANSDUCER_SENSIBILITY)*1000.0))
 
 
 //// VOLTAGE MEASUREMENT ////
 //used in DigiCom.c
 // *5/4096 (12bit ADC with Vref = 5V) *0.1 (divider bridge 50V -> 5V) *coeff - offset(trimming)
+// in integer, to mV : mV = (ADC*gain)/256 + offset
+#define VOLT_GAIN_Q8 ((int32_t)(1000.0/VOLT_CONVERSION_COEFF*256.0+0.5))
+#define VOLT_OFFSET ((int32_t)(VOLT_CONVERSION_OFFSET*1000.0))
 
-void handle_current_sensor(volatile float *f32_current, uint16_t u16_ADC_reg, uint8_t u8_sensor_num);
+int16_t current_sensor_mA(uint16_t u16_ADC_reg, uint8_t u8_sensor_num);
+void handle_current_sensor(volatile int16_t *i16_current, uint16_t u16_ADC_reg, uint8_t u8_sensor_num);
+void handle_voltage_sensor(volatile uint16_t *u16_volt, uint16_t u16_ADC_reg);
 void handle_temp_sensor(volatile uint8_t *u8_temp, uint16_t u16_ADC_reg);
-void handle_joulemeter(volatile float *f32_energy,volatile float f32_bat_current,volatile float f32_bat_voltage,volatile uint8_t u8_time_period);
 void handle_DWC(volatile ModuleValues_t *vals);
 void DWC_init();
 #endif /* SENSORS_H_ */
\ No newline at end of file
@@ -10,22 +10,110 @@
 #include "UniversalModuleDrivers/usbdb.h"
 #include "motor_controller_selection.h"
 #include "controller.h"
+#include "systime.h"
+#include "pid.h"
+#include "efficiency.h"
+#include "powertrain.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <stdlib.h>
 
-#define D_WHEEL 0.556 // in m
-#define PI 3.14
 #define DISTANCE D_WHEEL*PI/NUM_MAGNETS
+#define DISTANCE_MM ((uint32_t)(DISTANCE*1000.0+0.5)) // per magnet edge
 #define LOWPASS_CONSTANT_S 0.1
-#define GEAR_RATIO_1 18.75 //375/24 = 15.6, 375/18 = 20.8
-#define GEAR_RATIO_2 18.75 //200/16 = 12.5  (BELT mode)
 #define DUTY_CALC1 (1.08*6.0*GEAR_RATIO_1/(PI*D_WHEEL*VOLT_SPEED_CST*2))
 #define DUTY_CALC2 (0.9*6.0*GEAR_RATIO_2/(PI*D_WHEEL*VOLT_SPEED_CST*2))
 
-const float f32_speed_ratio = (17467.0/NUM_MAGNETS);
+//closed loop speed synchronisation (ENGAGE)
+#define SYNCH_RPM_PER_MM_S_Q16 ((int32_t)(60.0*GEAR_RATIO_1/(PI*D_WHEEL*1000.0)*65536.0)) // motor rpm per mm/s, same model as DUTY_CALC1
+#define SYNCH_KI_NUM ((int32_t)(640000.0/VOLT_SPEED_CST)) // 1/256 % of duty per rpm of error and per mV of battery, each 5ms (100ms time constant)
+#define SYNCH_CORR_MAX_Q8 (10*256) // the correction on top of compute_synch_duty() is bounded to +-10%
+#define SYNCH_INTEGRATE_RPM 600 // the correction integrates closer than that (above the feed forward error, ~13% at most)
+#define SYNCH_TOLERANCE_RPM 100 // the duty cycle resolution is about 1%, ~120rpm at 40V
+#define SYNCH_SETTLE_TICKS 4 // within tolerance for 20ms before telling the clutch
+
+#define SPEED_RATIO_US (17467000UL/NUM_MAGNETS) // speed = ratio/period in us
+#define SPEED_DEBOUNCE_US 70000 //edges closer than that to the last one are bounces
+
+//speed observer, every 5ms : speed and acceleration in mm/s and mm/s2, Q8
+#define SPEED_UNIT_MM_S 100 // u16_car_speed unit, in mm/s
+#define OBS_TIMESTEP_DIV 200 // 5ms
+#define CAR_MASS 120.0 // car and driver, in kg
+#define ACCEL_Q8_PER_A ((int32_t)(60.0/(2.0*PI*VOLT_SPEED_CST)*GEAR_RATIO_2/(D_WHEEL/2.0*CAR_MASS)*1000.0*256.0)) // motor torque to car acceleration
+#define MOTOR_RPM_PER_MM_S_Q16 ((int32_t)(60.0*GEAR_RATIO_2/(PI*D_WHEEL*1000.0)*65536.0)) // motor rpm per mm/s, belt drive
+#define WHEEL_RPM_PER_MM_S_Q16 ((int32_t)(60.0/(PI*D_WHEEL*1000.0)*65536.0))
+#define ENCODER_MM_S_PER_RPM_Q8 ((int32_t)(PI*D_WHEEL*1000.0/(60.0*GEAR_RATIO_1)*256.0)) // clutch encoder to car speed, gear engaged
+#define OBS_ACCEL_MAX_Q8 (2000L*256) // bound of the acceleration correction, 0.2g
+// correction gains on the measurement residual : speed += residual>>SPEED_SHIFT, acceleration += residual*gain (per s)
+#define OBS_WHEEL_SPEED_SHIFT 2
+#define OBS_WHEEL_ACCEL_SHIFT 1 // 0.5/s, wheel periods are ~100ms apart
+#define OBS_ENCODER_SPEED_SHIFT 1
+#define OBS_ENCODER_ACCEL_GAIN 2 // 2/s
+
+//cruise control, every 5ms : PI from the speed error (mm/s) to the motor current command (Q2 mA, gains in Q10)
+#define CRUISE_BANDWIDTH 0.5 // rad/s, the car mass is the plant (ACCEL_Q8_PER_A)
+#define CRUISE_TI 8.0 // s, integral time (drag and slope)
+#define CRUISE_KP (CRUISE_BANDWIDTH*256000.0/ACCEL_Q8_PER_A) // mA per mm/s
+#define CRUISE_GAIN_Q 10
+#define CRUISE_OUT_Q (CRUISE_GAIN_Q-PID_SHIFT)
+#define CRUISE_MAX_CURRENT 20000 // mA
+#define CRUISE_MIN_CURRENT -5000 // mA, regenerative braking downhill
+//bounds of the current command in Q2 mA, multiplied : a left shift of a negative value is undefined
+#define CRUISE_MAX_OUT ((int32_t)CRUISE_MAX_CURRENT*(1L << CRUISE_OUT_Q))
+#define CRUISE_MIN_OUT ((int32_t)CRUISE_MIN_CURRENT*(1L << CRUISE_OUT_Q))
+#define CRUISE_COAST_CURRENT 300 // mA, smaller commands are 0 : the drivers are off (IDLE) and the car coasts
+#define CRUISE_JERK_MAX 1000.0 // mm/s3, bounds the change of the current command
+#define CRUISE_SLEW_MA ((int32_t)(CRUISE_JERK_MAX*256000.0/ACCEL_Q8_PER_A*0.005)) // mA per step
+#define CRUISE_MIN_SPEED 2000 // mm/s, the cruise control is cancelled below
+//pulse and glide : bursts at least PG_MIN_ACCEL above the drag and slope (speed observer), at the most efficient current
+#define PG_MIN_ACCEL 100.0 // mm/s2
+#define PG_ACCEL_CURRENT ((int32_t)(PG_MIN_ACCEL*256000.0/ACCEL_Q8_PER_A)) // mA
 
 static uint16_t u16_speed_array [4];
 
+// integral correction of the duty cycle, from the speed error in rpm, in Q16.16 % of duty (gain in Q24)
+static Pid_t synch_pid = {
+	.i16_Kp = 0,
+	.i16_KiTs = 0, // set at each step, from the battery voltage
+	.i16_KdTs = 0,
+	.u16_KtTs = PID_KT_ONE, // the correction is clamped
+	.u16_d_filter = PID_FILTER_NONE,
+	.p_weight = PID_P_ON_ERROR,
+	.i32_out_min = -((int32_t)SYNCH_CORR_MAX_Q8 << 8),
+	.i32_out_max = (int32_t)SYNCH_CORR_MAX_Q8 << 8
+};
+static uint8_t u8_synch_count = 0 ;
+
+static Pid_t cruise_pid = {
+	.i16_Kp = PID_GAIN(CRUISE_KP, CRUISE_GAIN_Q),
+	.i16_KiTs = PID_GAIN(CRUISE_KP*0.005/CRUISE_TI, CRUISE_GAIN_Q),
+	.i16_KdTs = 0,
+	.u16_KtTs = PID_KT_ONE, // the integrator follows the current and jerk bounds
+	.u16_d_filter = PID_FILTER_NONE,
+	.p_weight = PID_P_ON_ERROR,
+	.i32_out_min = CRUISE_MIN_OUT,
+	.i32_out_max = CRUISE_MAX_OUT
+};
+static int32_t i32_cruise_out = 0 ; // last current command, in Q2 mA
+static uint8_t b_cruise_running = 0 ;
+static uint8_t b_pg_burst = 0 ; // pulse and glide : accelerating
+static uint8_t b_pg_cycle = 0 ; // a full cycle is being averaged
+static int16_t i16_pg_trim = 0 ; // band offset, mm/s, so that the average speed is the target
+static int32_t i32_pg_speed_sum = 0 ; // speed sum and steps since the last burst started
+static uint16_t u16_pg_ticks = 0 ;
+
+//written by the INT5 ISR, read by speed_update()
+static volatile uint32_t u32_last_edge_us = 0 ;
+static volatile uint32_t u32_period_us = 0 ; //0 : no valid period
+static volatile uint8_t b_edge_seen = 0 ;
+static volatile uint8_t b_new_period = 0 ;
+static volatile uint8_t b_new_encoder = 0 ; //set by speed_encoder_sample()
+static volatile uint32_t u32_edge_count = 0 ; //magnet edges, odometer
+
+static int32_t i32_obs_speed_q8 = 0 ; // mm/s
+static int32_t i32_obs_accel_corr_q8 = 0 ; // mm/s2, acceleration not explained by the motor torque (drag, slope, model error)
+static uint8_t b_obs_running = 0 ; //0 : stopped, the next wheel period initialises the speed
+
 void speed_init()
 {
 	//pin
@@ -51,22 +139,154 @@ void speed_init()
 	}
 }
 
-void handle_speed_sensor(volatile uint16_t *u16_speed, volatile uint16_t *u16_counter) // period in 1ms
+void handle_speed_sensor() // in the INT5 ISR, time stamps the magnet edge
+{
+	uint32_t u32_now = systime_us() ;
+	uint32_t u32_period = u32_now - u32_last_edge_us ;
+	
+	if (!b_edge_seen) //first edge after start up or a timeout, no period yet
+	{
+		u32_last_edge_us = u32_now ;
+		b_edge_seen = 1 ;
+		u32_edge_count ++ ;
+	}else if (u32_period > SPEED_DEBOUNCE_US)
+	{
+		u32_period_us = u32_period ;
+		u32_last_edge_us = u32_now ;
+		b_new_period = 1 ;
+		u32_edge_count ++ ;
+	}
+}
+
+void speed_encoder_sample(void) // a new clutch encoder speed was received
+{
+	b_new_encoder = 1 ;
+}
+
+/* Speed observer : the speed is predicted every 5ms from the motor current (torque) and an acceleration correction,
+* and corrected with the wheel magnet periods and, when the gear is engaged, with the clutch encoder speed.
+* The wheel period is the average speed over the period, it is brought forward to now with the acceleration.
+*/
+void speed_update(volatile ModuleValues_t *vals) // every 5ms
 {
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t u32_period = u32_period_us ;
+	uint32_t u32_since_edge = systime_us() - u32_last_edge_us ;
+	uint8_t b_period = b_new_period ;
+	uint8_t b_encoder = b_new_encoder ;
+	b_new_period = 0 ;
+	b_new_encoder = 0 ;
+	if (!b_edge_seen || u32_since_edge > SPEED_TIMEOUT_MS*1000UL)
+	{
+		b_edge_seen = 0 ;
+		u32_period_us = 0 ;
+		u32_period = 0 ;
+	}
+	SREG = sreg;
+	
+	uint8_t b_coupled = (vals->pwtrain_type == BELT || vals->gear_status == GEAR1) ; //motor torque reaches the wheel
+	uint8_t b_use_encoder = (vals->pwtrain_type == GEAR && vals->gear_status == GEAR1) ;
+	uint8_t b_driving = (vals->motor_status == ENGAGE || vals->motor_status == ACCEL || vals->motor_status == BRAKE ||
+	vals->motor_status == COMMISSION) ; //drivers(1) in these states (state_handler()), the motor current is torque
+	
+	//prediction
+	int32_t i32_accel_q8 = i32_obs_accel_corr_q8 ;
+	if (b_coupled && b_driving)
+	{
+		i32_accel_q8 += (int32_t)vals->i16_motor_current*ACCEL_Q8_PER_A/1000 ;
+	}
+	i32_obs_speed_q8 += i32_accel_q8/OBS_TIMESTEP_DIV ;
+	
+	//wheel magnets
+	if (u32_period == 0 && !b_use_encoder) //stopped
+	{
+		i32_obs_speed_q8 = 0 ;
+		i32_obs_accel_corr_q8 = 0 ;
+		b_obs_running = 0 ;
+	}else if (u32_period != 0)
+	{
+		if (b_period)
+		{
+			int32_t i32_delay_ms = (int32_t)((u32_period/2 + u32_since_edge)/1000) ;
+			int32_t i32_meas_q8 = (int32_t)(SPEED_RATIO_US*SPEED_UNIT_MM_S/u32_period) << 8 ;
+			i32_meas_q8 += i32_accel_q8*i32_delay_ms/1000 ;
+			int32_t i32_residual = i32_meas_q8 - i32_obs_speed_q8 ;
+			if (b_obs_running)
+			{
+				i32_obs_speed_q8 += i32_residual >> OBS_WHEEL_SPEED_SHIFT ;
+				i32_obs_accel_corr_q8 += i32_residual >> OBS_WHEEL_ACCEL_SHIFT ;
+			} else {
+				i32_obs_speed_q8 = i32_meas_q8 ;
+				b_obs_running = 1 ;
+			}
+		}
+		if (u32_since_edge > u32_period) //slowing down, the next edge is late : the speed is at most that
+		{
+			int32_t i32_bound_q8 = (int32_t)(SPEED_RATIO_US*SPEED_UNIT_MM_S/u32_since_edge) << 8 ;
+			if (i32_obs_speed_q8 > i32_bound_q8)
+			{
+				i32_obs_speed_q8 = i32_bound_q8 ;
+			}
+		}
+	}
+	
+	//clutch encoder
+	if (b_use_encoder && b_encoder)
+	{
+		int32_t i32_residual = (int32_t)vals->u16_motor_speed*ENCODER_MM_S_PER_RPM_Q8 - i32_obs_speed_q8 ;
+		i32_obs_speed_q8 += i32_residual >> OBS_ENCODER_SPEED_SHIFT ;
+		i32_obs_accel_corr_q8 += i32_residual*OBS_ENCODER_ACCEL_GAIN ;
+	}
 	
-	if (*u16_counter > 70)
+	if (i32_obs_accel_corr_q8 > OBS_ACCEL_MAX_Q8)
+	{
+		i32_obs_accel_corr_q8 = OBS_ACCEL_MAX_Q8 ;
+	}
+	if (i32_obs_accel_corr_q8 < -OBS_ACCEL_MAX_Q8)
+	{
+		i32_obs_accel_corr_q8 = -OBS_ACCEL_MAX_Q8 ;
+	}
+	if (i32_obs_speed_q8 < 0)
+	{
+		i32_obs_speed_q8 = 0 ;
+	}
+	
+	vals->u16_car_speed = (uint16_t)((i32_obs_speed_q8 + (SPEED_UNIT_MM_S << 7))/(SPEED_UNIT_MM_S << 8)) ;
+	vals->u16_car_speed_mm_s = (uint16_t)((i32_obs_speed_q8 + 128) >> 8) ;
+	vals->i16_car_accel = (int16_t)(i32_accel_q8 >> 8) ;
+}
+
+uint32_t speed_get_distance_mm(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t u32_edges = u32_edge_count ;
+	SREG = sreg;
+	return u32_edges*DISTANCE_MM ;
+}
+
+uint16_t motor_speed_estimate(volatile ModuleValues_t *vals) // in rpm
+{
+	if (vals->pwtrain_type == GEAR && vals->gear_status == GEAR1)
 	{
-		*u16_speed = (uint16_t)(f32_speed_ratio/((float)*u16_counter));
-		*u16_counter = 0 ;
-	}	
+		return vals->u16_motor_speed ; //clutch encoder
+	}
+	return (uint16_t)(((uint32_t)vals->u16_car_speed_mm_s*MOTOR_RPM_PER_MM_S_Q16) >> 16) ;
+}
+
+uint16_t wheel_speed_rpm(volatile ModuleValues_t *vals)
+{
+	return (uint16_t)(((uint32_t)vals->u16_car_speed_mm_s*WHEEL_RPM_PER_MM_S_Q16) >> 16) ;
 }
 
-uint8_t compute_synch_duty(volatile uint8_t speed_10ms, ClutchState_t gear, float vbatt) // computing the duty cycle to reach synchronous speed before engaging the gears
+uint8_t compute_synch_duty(uint16_t u16_speed_mm_s, ClutchState_t gear, uint16_t u16_vbatt) // computing the duty cycle to reach synchronous speed before engaging the gears
 {
 	uint8_t Duty = 50 ;
+	float vbatt = (float)u16_vbatt/1000.0 ;
 	if (gear == GEAR1)//gear powertrain
 	{
-		Duty = (speed_10ms*DUTY_CALC1/vbatt)*100 + 50 ;// Vm/2Vbatt +0.5
+		Duty = u16_speed_mm_s*DUTY_CALC1/vbatt + 50 ;// Vm/2Vbatt +0.5, DUTY_CALC1 per 0.1m/s and in %
 		if (Duty == 50)
 		{
 			Duty = 52 ;
@@ -74,7 +294,208 @@ uint8_t compute_synch_duty(volatile uint8_t speed_10ms, ClutchState_t gear, floa
 	}
 	if (gear == GEAR2)//for belt powertrain
 	{
-		Duty = (speed_10ms*DUTY_CALC2/vbatt)*100 + 50 ;// Vm/2Vbatt +0.5	
+		Duty = u16_speed_mm_s*DUTY_CALC2/vbatt + 50 ;// Vm/2Vbatt +0.5, DUTY_CALC2 per 0.1m/s and in %
 	}
 	return Duty ;
 }
+
+void synch_reset(void)
+{
+	pid_reset(&synch_pid);
+	u8_synch_count = 0 ;
+}
+
+uint8_t synch_speed_control(volatile ModuleValues_t *vals) // every 5ms in ENGAGE, duty cycle bringing the motor to the wheel speed
+{
+	int16_t i16_duty_q8 = (int16_t)compute_synch_duty(vals->u16_car_speed_mm_s, vals->gear_required, vals->u16_batt_volt) << 8 ; //feed forward
+	int16_t i16_target = (int16_t)(((int32_t)vals->u16_car_speed_mm_s*SYNCH_RPM_PER_MM_S_Q16) >> 16) ;
+	int16_t i16_error = i16_target - (int16_t)vals->u16_motor_speed ; //motor speed from the clutch encoder
+	int32_t i32_corr = 0 ;
+	
+	if (vals->u16_batt_volt > 0)
+	{
+		// held while the motor spins up on the feed forward, or the correction winds up and overshoots
+		int16_t i16_KiTs = (abs(i16_error) <= SYNCH_INTEGRATE_RPM) ? pid_sat16((SYNCH_KI_NUM << 16)/vals->u16_batt_volt) : 0 ;
+		pid_set_gains(&synch_pid, 0, i16_KiTs) ;
+		i32_corr = pid_update(&synch_pid, i16_target, (int16_t)vals->u16_motor_speed, 0) ;
+	}
+	
+	if (abs(i16_error) <= SYNCH_TOLERANCE_RPM)
+	{
+		if (u8_synch_count < SYNCH_SETTLE_TICKS)
+		{
+			u8_synch_count ++ ;
+		}
+	} else {
+		u8_synch_count = 0 ;
+	}
+	vals->b_speed_synch = (u8_synch_count >= SYNCH_SETTLE_TICKS) ;
+	
+	i16_duty_q8 += (int16_t)(i32_corr >> 8) + 128 ; //rounded to the closest %
+	if (i16_duty_q8 > (95 << 8))
+	{
+		i16_duty_q8 = 95 << 8 ;
+	}
+	if (i16_duty_q8 < (50 << 8))
+	{
+		i16_duty_q8 = 50 << 8 ;
+	}
+	return (uint8_t)(i16_duty_q8 >> 8) ;
+}
+
+void cruise_set_kmh(volatile ModuleValues_t *vals, uint8_t u8_kmh)
+{
+	if (u8_kmh > CRUISE_MAX_KMH)
+	{
+		u8_kmh = CRUISE_MAX_KMH ;
+	}
+	uint16_t u16_target = (uint16_t)((uint32_t)u8_kmh*2500/9) ; // km/h to mm/s
+	vals->u16_cruise_speed = (u16_target >= CRUISE_MIN_SPEED) ? u16_target : 0 ;
+}
+
+void cruise_set_band_kmh(volatile ModuleValues_t *vals, uint8_t u8_kmh)
+{
+	if (u8_kmh > CRUISE_MAX_BAND_KMH)
+	{
+		u8_kmh = CRUISE_MAX_BAND_KMH ;
+	}
+	vals->u16_cruise_band = (uint16_t)((uint32_t)u8_kmh*2500/9) ;
+}
+
+/* Pulse and glide : the car coasts (drivers off) down to the bottom of the speed band, then accelerates up to the top.
+* The burst current is the most efficient one of the motor at the speed (efficiency map), at least enough to accelerate
+* by PG_MIN_ACCEL against the drag and slope estimated by the speed observer. The band is shifted after each cycle
+* so that the average speed over the cycle (not the middle of the band, the car slows faster at high speed) is the target.
+*/
+static int32_t pulse_glide_target(volatile ModuleValues_t *vals, int16_t i16_speed) // current command, in Q2 mA
+{
+	int16_t i16_half_band = (int16_t)(vals->u16_cruise_band/2) ;
+	int16_t i16_target = (int16_t)vals->u16_cruise_speed ;
+	
+	if (!b_pg_burst && i16_speed <= i16_target - i16_half_band + i16_pg_trim) // end of the glide, a new cycle
+	{
+		if (b_pg_cycle && u16_pg_ticks > 0)
+		{
+			i16_pg_trim += (i16_target - (int16_t)(i32_pg_speed_sum/u16_pg_ticks))/2 ;
+			if (i16_pg_trim > i16_half_band)
+			{
+				i16_pg_trim = i16_half_band ;
+			}
+			if (i16_pg_trim < -i16_half_band)
+			{
+				i16_pg_trim = -i16_half_band ;
+			}
+		}
+		i32_pg_speed_sum = 0 ;
+		u16_pg_ticks = 0 ;
+		b_pg_cycle = 1 ;
+		b_pg_burst = 1 ;
+	}
+	if (b_pg_burst && i16_speed >= i16_target + i16_half_band + i16_pg_trim)
+	{
+		b_pg_burst = 0 ;
+	}
+	
+	if (u16_pg_ticks < 0xFFFF)
+	{
+		i32_pg_speed_sum += i16_speed ;
+		u16_pg_ticks ++ ;
+	}else{
+		b_pg_cycle = 0 ; // too long to be a cycle
+	}
+	
+	if (!b_pg_burst)
+	{
+		return 0 ;
+	}
+	int32_t i32_min = -i32_obs_accel_corr_q8*1000/ACCEL_Q8_PER_A ; // mA holding the speed
+	if (i32_min < 0)
+	{
+		i32_min = 0 ;
+	}
+	i32_min += PG_ACCEL_CURRENT ;
+	if (i32_min > CRUISE_MAX_CURRENT)
+	{
+		i32_min = CRUISE_MAX_CURRENT ;
+	}
+	return (int32_t)efficiency_best_current(motor_speed_estimate(vals), (uint16_t)i32_min, CRUISE_MAX_CURRENT) << CRUISE_OUT_Q ;
+}
+
+/* Cruise control : the speed observer estimate is regulated to vals->u16_cruise_speed by a PI giving the motor current,
+* which the current loop then follows in ACCEL and BRAKE (the state machine selects the state from its sign).
+* The current command is bounded, and so is its change at each step (jerk). The integrator follows the bounds.
+* With a speed band, the current command is the one of the pulse and glide instead (see pulse_glide_target()).
+* The brakes, a fault or a speed below CRUISE_MIN_SPEED cancel the target. The accelerator overrides the speed loop
+* while it is pressed, the speed loop starts again from the current at that time.
+*/
+void cruise_control(volatile ModuleValues_t *vals) // every 5ms
+{
+	int16_t i16_speed = (int16_t)(i32_obs_speed_q8 >> 8) ; // mm/s
+	
+	if (vals->u8_brake_cmd > 0 || i16_speed < CRUISE_MIN_SPEED ||
+	(vals->motor_status != IDLE && vals->motor_status != ACCEL && vals->motor_status != BRAKE && vals->motor_status != ENGAGE))
+	{
+		vals->u16_cruise_speed = 0 ;
+	}
+	if (vals->u16_cruise_speed == 0 || vals->u8_accel_cmd > 0)
+	{
+		b_cruise_running = 0 ;
+		vals->b_cruise = 0 ;
+		vals->i16_cruise_current = 0 ;
+		return ;
+	}
+	
+	if (!b_cruise_running) // bumpless start, from the current of the motor (0 when coasting)
+	{
+		i32_cruise_out = 0 ;
+		if (vals->motor_status == ACCEL || vals->motor_status == BRAKE)
+		{
+			i32_cruise_out = (int32_t)vals->i16_motor_current*(1L << CRUISE_OUT_Q) ;
+		}
+		if (i32_cruise_out > CRUISE_MAX_OUT)
+		{
+			i32_cruise_out = CRUISE_MAX_OUT ;
+		}
+		if (i32_cruise_out < CRUISE_MIN_OUT)
+		{
+			i32_cruise_out = CRUISE_MIN_OUT ;
+		}
+		pid_reset(&cruise_pid);
+		pid_track(&cruise_pid, i32_cruise_out);
+		b_pg_burst = 0 ;
+		b_pg_cycle = 0 ;
+		i16_pg_trim = 0 ;
+		b_cruise_running = 1 ;
+	}
+	
+	if (vals->motor_status != ENGAGE) // the command is held while the gear engages
+	{
+		int32_t i32_min = i32_cruise_out - (CRUISE_SLEW_MA << CRUISE_OUT_Q) ;
+		int32_t i32_max = i32_cruise_out + (CRUISE_SLEW_MA << CRUISE_OUT_Q) ;
+		if (i32_min < CRUISE_MIN_OUT)
+		{
+			i32_min = CRUISE_MIN_OUT ;
+		}
+		if (i32_max > CRUISE_MAX_OUT)
+		{
+			i32_max = CRUISE_MAX_OUT ;
+		}
+		if (vals->u16_cruise_band > 0)
+		{
+			int32_t i32_target = pulse_glide_target(vals, i16_speed) ;
+			i32_cruise_out = (i32_target > i32_max) ? i32_max : ((i32_target < i32_min) ? i32_min : i32_target) ;
+			pid_track(&cruise_pid, i32_cruise_out); // bumpless to constant speed
+		}else{
+			pid_set_limits(&cruise_pid, i32_min, i32_max);
+			i32_cruise_out = pid_update(&cruise_pid, (int16_t)vals->u16_cruise_speed, i16_speed, 0) ;
+		}
+	}
+	
+	int16_t i16_current = (int16_t)(i32_cruise_out >> CRUISE_OUT_Q) ;
+	if (abs(i16_current) < CRUISE_COAST_CURRENT)
+	{
+		i16_current = 0 ;
+	}
+	vals->i16_cruise_current = i16_current ;
+	vals->b_cruise = 1 ;
+}
@@ -14,7 +14,23 @@
 
 
 void speed_init();
-void handle_speed_sensor(volatile uint16_t *u16_speed, volatile uint16_t *u16_counter); //speed in m/s
-uint8_t compute_synch_duty(volatile uint8_t speed_ms, ClutchState_t gear, float vbatt);
+void handle_speed_sensor(); //from the speed sensor interrupt
+void speed_encoder_sample(void); //on reception of the clutch encoder speed
+void speed_update(volatile ModuleValues_t *vals); //speed observer, sets u16_car_speed, u16_car_speed_mm_s and i16_car_accel
+uint32_t speed_get_distance_mm(void); //odometer, from the magnet edges (wraps around, differences stay valid)
+uint16_t motor_speed_estimate(volatile ModuleValues_t *vals); //rpm, clutch encoder when engaged, from the car speed otherwise
+uint16_t wheel_speed_rpm(volatile ModuleValues_t *vals); //from the car speed
+uint8_t compute_synch_duty(uint16_t u16_speed_mm_s, ClutchState_t gear, uint16_t u16_vbatt); //vbatt in mV
+void synch_reset(void);
+uint8_t synch_speed_control(volatile ModuleValues_t *vals); //sets vals->b_speed_synch
+
+//cruise control : speed loop every 5ms giving the current command of ACCEL and BRAKE
+#define CRUISE_UART_CMD 2000 //value to send through UART : CRUISE_UART_CMD+v for v km/h, CRUISE_UART_CMD alone is off
+#define CRUISE_MAX_KMH 50
+#define CRUISE_MAX_BAND_KMH 20
+#define PULSE_GLIDE_UART_CMD 2100 //PULSE_GLIDE_UART_CMD+w : pulse and glide within a w km/h band around the cruise speed, 0 : constant speed
+void cruise_set_kmh(volatile ModuleValues_t *vals, uint8_t u8_kmh); //target speed, 0 : off
+void cruise_set_band_kmh(volatile ModuleValues_t *vals, uint8_t u8_kmh); //pulse and glide speed band, 0 : constant speed
+void cruise_control(volatile ModuleValues_t *vals); //sets vals->b_cruise and vals->i16_cruise_current, before the state transitions
 
 #endif /* SPEED_H_ */
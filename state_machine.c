@@ -10,10 +10,14 @@
 #include "state_machine.h"
 #include "controller.h"
 #include "speed.h"
+#include "commission.h"
+#include "energy.h"
+#include "efficiency.h"
+#include "systime.h"
 
-#define MAX_VOLT 55.0
-#define MIN_VOLT 15.0
-#define MAX_AMP 25.0
+#define MAX_VOLT 55000 //mV
+#define MIN_VOLT 15000 //mV
+#define MAX_AMP 25000 //mA
 #define MAX_TEMP 100
 
 static uint8_t b_major_fault = 0;
@@ -21,12 +25,44 @@ static uint8_t fault_count = 0;
 static uint16_t fault_timeout = 0;
 static uint8_t fault_clear_count = 0;
 static uint8_t starting_engage = 0;
+static uint16_t u16_engage_ticks = 0;
+
+//throttle of the driver or current command of the cruise control (see cruise_control())
+static uint8_t accel_request(volatile ModuleValues_t * vals)
+{
+	return (vals->u8_accel_cmd > 0 || (vals->b_cruise && vals->i16_cruise_current > 0)) ;
+}
+
+static uint8_t brake_request(volatile ModuleValues_t * vals)
+{
+	return (vals->u8_brake_cmd > 0 || (vals->b_cruise && vals->i16_cruise_current < 0)) ;
+}
+
+static void run_current_loop(volatile ModuleValues_t * vals)
+{
+	#ifndef CURRENT_LOOP_PWM_SYNC
+	uint16_t u16_start = TCNT1 ; // timed as in the timer 3 ISR, for the UART telemetry
+	controller(vals);
+	uint16_t u16_cycles = systime_cycles(u16_start) ;
+	if (u16_cycles > vals->u16_ctrl_cycles_max)
+	{
+		vals->u16_ctrl_cycles_max = u16_cycles ;
+	}
+	#endif
+	// in PWM synchronous mode, the current loop runs from the timer 3 ISR (see main.c) in ACCEL, BRAKE and ENGAGE
+}
 
 void state_handler(volatile ModuleValues_t * vals)
 {
-	uint8_t b_board_powered = (vals->f32_batt_volt >= MIN_VOLT  && vals->f32_batt_volt < 100.0);
+	uint8_t b_board_powered = (vals->u16_batt_volt >= MIN_VOLT); //the measurement range ends at 60V
 	
-	if (b_board_powered && (vals->f32_motor_current >= MAX_AMP|| vals->f32_motor_current <= -MAX_AMP || vals->f32_batt_volt > MAX_VOLT))
+	controller_feedforward(vals); // back-EMF and R.I terms of the current loop, from the speed and battery voltage
+	cruise_control(vals); // speed loop, current command of ACCEL and BRAKE when a target speed is set
+	#ifdef TORQUE_SPLIT
+	torque_command(vals); // share of this motor in the accelerator command
+	#endif
+	
+	if (b_board_powered && (vals->i16_motor_current >= MAX_AMP|| vals->i16_motor_current <= -MAX_AMP || vals->u16_batt_volt > MAX_VOLT))
 	{
 		fault_count ++ ;
 		if (fault_count == 3) // a fault is cleared after some time and a maximum of three times. If the fault occurs more than three times, 
@@ -73,25 +109,41 @@ void state_handler(volatile ModuleValues_t * vals)
 				vals->u8_duty_cycle = 50 ;
 				
 				//transition 7
-				if (vals->u8_brake_cmd > 0)
+				if (brake_request(vals))
 				{
-					vals->u8_duty_cycle = compute_synch_duty(vals->u16_car_speed, GEAR2, vals->f32_batt_volt) ; //Setting duty
+					vals->u8_duty_cycle = compute_synch_duty(vals->u16_car_speed_mm_s, GEAR2, vals->u16_batt_volt) ; //Setting duty
+					#if defined(CURRENT_LOOP_FEEDFORWARD) || defined(CURRENT_LOOP_DEADBEAT)
+					reset_I(); //the feed forward gives the duty cycle at the current speed
+					#else
 					set_I(vals->u8_duty_cycle) ; //set integrator
+					#endif
 					vals->motor_status = BRAKE;
 				}
 				//transition 5
-				if (vals->u8_accel_cmd > 0)
+				if (accel_request(vals))
 				{
-					vals->u8_duty_cycle = compute_synch_duty(vals->u16_car_speed, GEAR2, vals->f32_batt_volt) ; //Setting duty
+					vals->u8_duty_cycle = compute_synch_duty(vals->u16_car_speed_mm_s, GEAR2, vals->u16_batt_volt) ; //Setting duty
+					#if defined(CURRENT_LOOP_FEEDFORWARD) || defined(CURRENT_LOOP_DEADBEAT)
+					reset_I(); //the feed forward gives the duty cycle at the current speed
+					#else
 					set_I(vals->u8_duty_cycle) ; //set integrator
+					#endif
 					vals->motor_status = ACCEL;
 				}
 			}
 			
+			//commissioning, car stopped and no throttle
+			if (vals->b_commission_request && vals->u16_car_speed == 0 && vals->u8_accel_cmd == 0 && vals->u8_brake_cmd == 0 && vals->motor_status == IDLE)
+			{
+				vals->b_commission_request = 0;
+				commission_start();
+				vals->motor_status = COMMISSION;
+			}
+			
 			if (vals->pwtrain_type == GEAR)
 			{
 				//transition 5
-				if ((vals->u8_accel_cmd > 0 || vals->u8_brake_cmd > 0) && vals->gear_status == NEUTRAL)
+				if ((accel_request(vals) || brake_request(vals)) && vals->gear_status == NEUTRAL)
 				{
 					vals->motor_status = ENGAGE;
 					starting_engage = 1;
@@ -109,37 +161,50 @@ void state_handler(volatile ModuleValues_t * vals)
 			vals->gear_required = GEAR1;
 			if (starting_engage)
 			{
-				vals->u8_duty_cycle = compute_synch_duty(vals->u16_car_speed, vals->gear_required, vals->f32_batt_volt) ; //Setting duty
+				vals->u8_duty_cycle = compute_synch_duty(vals->u16_car_speed_mm_s, vals->gear_required, vals->u16_batt_volt) ; //Setting duty
 				set_I(vals->u8_duty_cycle) ; //set integrator
+				synch_reset();
+				u16_engage_ticks = 0;
 				starting_engage = 0;
 			}
+			#ifdef ENGAGE_CLOSED_LOOP_SYNCH
+			vals->u8_duty_cycle = synch_speed_control(vals) ; //motor speed regulated to the wheel speed
+			#endif
+			if (u16_engage_ticks < 0xFFFF)
+			{
+				u16_engage_ticks ++ ;
+			}
 			//save_ctrl_type = vals->ctrl_type ; // PWM type ctrl is needed only for the engagement process. The mode will be reverted to previous in ACCEL and BRAKE modes
 			vals->ctrl_type = PWM ;
-			controller(vals) ; //speed up motor to synch speed
+			run_current_loop(vals) ; //speed up motor to synch speed
 			drivers(1);
+			if (vals->gear_status == GEAR1)
+			{
+				vals->u16_engage_time = u16_engage_ticks*5 ;
+			}
 			//transition 9, GEAR
-			if (vals->u8_brake_cmd > 0 && vals->gear_status == GEAR1)
+			if (brake_request(vals) && vals->gear_status == GEAR1)
 			{
 				vals->motor_status = BRAKE;
 			}
 			//transition 10, GEAR
-			if (vals->u8_accel_cmd > 0 && vals->gear_status == GEAR1)
+			if (accel_request(vals) && vals->gear_status == GEAR1)
 			{
 				vals->motor_status = ACCEL;
 			}
 			//transition 11, GEAR
-			if (vals->u8_accel_cmd == 0 && vals->u8_brake_cmd == 0 && vals->u16_watchdog_throttle == 0)
+			if (!accel_request(vals) && !brake_request(vals) && vals->u16_watchdog_throttle == 0)
 			{
 				vals->motor_status = IDLE;
 			}
 		break;
 		
 		case ACCEL:			
-			vals->ctrl_type = CURRENT;
-			controller(vals);
+			vals->ctrl_type = CURRENT_CTRL_TYPE;
+			run_current_loop(vals);
 			drivers(1);
 			//transition 6
-			if (vals->u8_accel_cmd == 0 && vals->u16_watchdog_throttle == 0)
+			if (!accel_request(vals) && vals->u16_watchdog_throttle == 0)
 			{
 				vals->motor_status = IDLE;
 			}
@@ -150,18 +215,18 @@ void state_handler(volatile ModuleValues_t * vals)
 				starting_engage = 1;
 			}
 			//transition 14
-			if (vals->u8_brake_cmd > 0 && vals->u8_accel_cmd == 0)
+			if (brake_request(vals) && !accel_request(vals))
 			{
 				vals->motor_status = BRAKE;
 			}
 		break;
 		
 		case BRAKE:
-			vals->ctrl_type = CURRENT ;
-			controller(vals); //negative throttle cmd
+			vals->ctrl_type = CURRENT_CTRL_TYPE ;
+			run_current_loop(vals); //negative throttle cmd
 			drivers(1);
 			//transition 8
-			if (vals->u8_brake_cmd == 0 && vals->u16_watchdog_throttle == 0)
+			if (!brake_request(vals) && vals->u16_watchdog_throttle == 0)
 			{
 				vals->motor_status = IDLE;
 			}
@@ -172,12 +237,22 @@ void state_handler(volatile ModuleValues_t * vals)
 				starting_engage = 1;
 			}
 			//transition 15
-			if (vals->u8_brake_cmd == 0 && vals->u8_accel_cmd > 0)
+			if (!brake_request(vals) && accel_request(vals))
 			{
 				vals->motor_status = ACCEL;
 			}
 		break;
 		
+		case COMMISSION:
+			vals->ctrl_type = PWM ;
+			drivers(1);
+			if (commission_step(vals) != COMMISSION_RUNNING || vals->u8_accel_cmd > 0 || vals->u8_brake_cmd > 0)
+			{
+				vals->u8_duty_cycle = 50 ;
+				vals->motor_status = IDLE;
+			}
+		break;
+		
 		case ERR:
 			//transition 4
 			if (!b_major_fault && vals->u8_motor_temp < MAX_TEMP)
@@ -194,7 +269,12 @@ void state_handler(volatile ModuleValues_t * vals)
 		break;	
 	}
 	
-	if ((vals->motor_status == IDLE || vals->motor_status == ACCEL || vals->motor_status == BRAKE || vals->motor_status == ENGAGE) && (vals->u16_watchdog_can == 0 || !b_board_powered))
+	if (vals->motor_status != ENGAGE)
+	{
+		vals->b_speed_synch = 0;
+	}
+	
+	if ((vals->motor_status == IDLE || vals->motor_status == ACCEL || vals->motor_status == BRAKE || vals->motor_status == ENGAGE || vals->motor_status == COMMISSION) && (vals->u16_watchdog_can == 0 || !b_board_powered))
 	{
 		// transition 2
 		vals->motor_status = OFF;
@@ -205,4 +285,12 @@ void state_handler(volatile ModuleValues_t * vals)
 		//transition 3
 		vals->motor_status = ERR;
 	}
+	
+	DriveMode_t drive_mode = DRIVE_MANUAL ;
+	if (vals->b_cruise)
+	{
+		drive_mode = (vals->u16_cruise_band > 0) ? DRIVE_PULSE_GLIDE : DRIVE_CRUISE ;
+	}
+	energy_lap_tick(drive_mode, speed_get_distance_mm()); // energy per lap, per driving mode
+	efficiency_learn(vals); // measured efficiency of the motor, in ACCEL
 }
\ No newline at end of file
@@ -19,7 +19,8 @@ typedef enum {
 	BRAKE = 2, //Receiving BRAKE cmd
 	IDLE = 3, //receiving 0 current cmd (car rolling, current loop is running with 0A cmd
 	ERR = 4, //error mode
-	ENGAGE = 5 //waiting for the clutch to engage
+	ENGAGE = 5, //waiting for the clutch to engage
+	COMMISSION = 6 //identification of the motor resistance and inductance, at standstill (see commission.c)
 } MotorControllerState_t;
 
 typedef enum
@@ -44,18 +45,29 @@ typedef enum
 typedef enum
 {
 	CURRENT = 0,
-	PWM = 1
+	PWM = 1,
+	DEADBEAT = 2 //current control from the motor model, see CURRENT_LOOP_DEADBEAT
 } ControlType_t ;
 
+typedef enum
+{
+	DRIVE_MANUAL = 0, //throttle of the driver
+	DRIVE_CRUISE = 1, //constant speed (see cruise_control())
+	DRIVE_PULSE_GLIDE = 2 //bursts at the most efficient current and coasting, within a speed band
+} DriveMode_t ;
+
 typedef struct{
-	float f32_motor_current;
-	float f32_batt_current;
-	float f32_batt_volt;
-	float f32_energy ;
+	int16_t i16_motor_current; //in mA
+	int16_t i16_motor_current_sample; //last sample, not filtered, in mA (deadbeat current control)
+	int16_t i16_batt_current; //in mA
+	uint16_t u16_batt_volt; //in mV
 	uint8_t u8_motor_temp;
-	uint16_t u16_car_speed;
+	uint16_t u16_car_speed; //observer estimate, in 0.1m/s
+	uint16_t u16_car_speed_mm_s; //observer estimate, in mm/s (~0.6rpm of motor per unit), for the motor side controls
+	int16_t i16_car_accel; //observer estimate, in mm/s2
 	uint16_t u16_motor_speed;
 	uint8_t u8_accel_cmd;
+	uint16_t u16_accel_current; //current of this motor for u8_accel_cmd, in mA (TORQUE_SPLIT, see torque_command())
 	uint8_t u8_brake_cmd;
 	uint8_t u8_duty_cycle ;
 	uint16_t u16_watchdog_can ;
@@ -67,6 +79,16 @@ typedef struct{
 	uint8_t b_driver_status;
 	ControlType_t ctrl_type;
 	PowertrainType_t pwtrain_type;
+	uint8_t b_speed_synch ; //motor at the wheel speed in ENGAGE, sent to the clutch
+	uint16_t u16_engage_time ; //duration of the last engagement, in ms
+	uint8_t b_commission_request ; //set through UART, the commissioning starts from IDLE
+	uint16_t u16_ctrl_cycles_max ; //longest controller() call, in CPU cycles (timer 1, SYSTIME_CYCLES_PER_TICK resolution)
+	uint16_t u16_ctrl_overruns ; //number of current loop ISRs longer than CURRENT_LOOP_CYCLE_BUDGET
+	uint16_t u16_sample_misses ; //motor current samples skipped, compare match C ISR delayed past PWM_SAMPLE_WINDOW
+	uint16_t u16_cruise_speed ; //cruise control target speed, in mm/s (0 : off), see cruise_control()
+	int16_t i16_cruise_current ; //current command of the cruise control in ACCEL and BRAKE, in mA
+	uint16_t u16_cruise_band ; //pulse and glide speed band around u16_cruise_speed, in mm/s (0 : constant speed)
+	uint8_t b_cruise ; //the cruise control gives the current command (not overridden by the driver)
 
 }ModuleValues_t;
 
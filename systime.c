@@ -0,0 +1,69 @@
+/*
+ * systime.c
+ *
+ * Created: 12/05/2018 10:12:29
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : not hardware specific
+ */ 
+
+#include "systime.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile uint32_t u32_systime_ms = 0 ;
+static uint16_t u16_isr_cycles = 0 ; // this ms
+static volatile uint16_t u16_isr_cycles_max = 0 ;
+
+void systime_tick(void)
+{
+	u32_systime_ms ++ ;
+	if (u16_isr_cycles > u16_isr_cycles_max)
+	{
+		u16_isr_cycles_max = u16_isr_cycles ;
+	}
+	u16_isr_cycles = 0 ;
+}
+
+uint32_t systime_ms(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t u32_ms = u32_systime_ms ;
+	SREG = sreg;
+	return u32_ms ;
+}
+
+uint32_t systime_us(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint32_t u32_ms = u32_systime_ms ;
+	uint16_t u16_ticks = TCNT1 ;
+	if ((TIFR1 & (1<<OCF1A)) && u16_ticks < SYSTIME_TICKS_PER_MS/2) // compare match pending : the timer restarted but the ms is not counted yet
+	{
+		u32_ms ++ ;
+	}
+	SREG = sreg;
+	return u32_ms*1000 + u16_ticks ;
+}
+
+uint16_t systime_cycles(uint16_t u16_start)
+{
+	uint16_t u16_stop = TCNT1 ;
+	uint16_t u16_ticks = (u16_stop >= u16_start) ? (u16_stop-u16_start) : (u16_stop+SYSTIME_TICKS_PER_MS-u16_start) ; // CTC, wraps every ms
+	return u16_ticks*SYSTIME_CYCLES_PER_TICK ;
+}
+
+void systime_isr_cycles(uint16_t u16_start) // interrupts off (ISR)
+{
+	u16_isr_cycles += systime_cycles(u16_start) ;
+}
+
+uint16_t systime_isr_cycles_max(void)
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t u16_max = u16_isr_cycles_max ;
+	SREG = sreg;
+	return u16_max ;
+}
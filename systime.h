@@ -0,0 +1,28 @@
+/*
+ * systime.h
+ *
+ * Created: 12/05/2018 10:12:41
+ * Author : Tanguy Simon for DNV GL Fuel fighter
+ * Corresponding Hardware : not hardware specific
+ */ 
+
+#ifndef SYSTIME_H_
+#define SYSTIME_H_
+
+#include <avr/io.h>
+
+// time base on timer 1 : CTC every 1ms with 1us ticks (see timer1_init_ts() in main.c)
+#define SYSTIME_TICKS_PER_MS 1000
+#define SYSTIME_CYCLES_PER_TICK 8 // timer 1 prescaler, CLK/8
+
+void systime_tick(void); // to call from the timer 1 compare ISR
+uint32_t systime_ms(void); // ms since power up
+uint32_t systime_us(void); // us since power up, wraps around after 71 minutes (differences stay valid)
+uint16_t systime_cycles(uint16_t u16_start); // CPU cycles since TCNT1 was u16_start (less than 1ms ago), SYSTIME_CYCLES_PER_TICK resolution
+
+// interrupt load of the acquisition ISRs (timer 1, timer 3 compare C, SPI) : cycles summed over each ms, from one timer 1
+// tick to the next. Timed from the first statement of the ISR to its end (prologue and epilogue not counted).
+void systime_isr_cycles(uint16_t u16_start); // at the end of an instrumented ISR, TCNT1 read at its start
+uint16_t systime_isr_cycles_max(void); // highest sum over one ms since power up
+
+#endif /* SYSTIME_H_ */
@@ -0,0 +1,25 @@
+/*
+ * thermistor_table.h
+ *
+ * Generated by tools/thermistor_table_gen.c, do not edit.
+ * Beta model R25 = 10000, B = 3988, R fixed = 10000
+ * Interpolation error from 0 to 120 degC : 0.95 degC max
+ */
+
+#ifndef THERMISTOR_TABLE_H_
+#define THERMISTOR_TABLE_H_
+
+#include <avr/pgmspace.h>
+
+#define THERMISTOR_INDEX_SHIFT 6 // index = ADC code >> THERMISTOR_INDEX_SHIFT
+#define THERMISTOR_Q_SHIFT 4 // temperatures in 1/16 degC
+
+const int16_t PROGMEM thermistor_table[65] = {
+	-640,-640,-575,-477,-403,-343,-292,-247,-206,-169,-134,-102,-71,-42,-15,12,
+	38,63,87,111,134,157,180,202,225,247,268,290,312,334,356,378,
+	400,422,445,468,491,515,539,564,589,615,642,670,699,729,760,793,
+	827,863,902,943,987,1035,1088,1147,1212,1287,1374,1479,1611,1787,2048,2541,
+	4080
+};
+
+#endif /* THERMISTOR_TABLE_H_ */
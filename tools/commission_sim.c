@@ -0,0 +1,206 @@
+/*
+ * commission_sim.c
+ *
+ * Host side check (not part of the firmware) of the motor identification of commission.c, on a model of the winding.
+ * Build and run on the computer : ./commission_sim.sh, the exit code is 1 when the check fails.
+ *
+ * commission.c is included, so that its state can be read and reset between runs. commission_step() runs every 5ms,
+ * the duty cycle is applied as by controller.c in PWM mode (OCR3A and OCR3B truncated to a count, UNIPOLAR).
+ * Winding model : R and L, at standstill, with a voltage drop of the bridge (dead time, diodes) against the current.
+ * The motor current is given to the state machine with SIM_NOISE_MA of uniform noise. The inductance steps : the new
+ * compare values are loaded at the end of the PWM period (uniform delay over a period), the captured conversion starts
+ * at a uniform time within SIM_SAMPLE_PERIOD_US of the step, its raw value is the current in mA plus the noise.
+ *
+ * For each motor of controller.h, battery voltage and bridge drop, R and L are identified and compared to the model.
+ * R must be within SIM_R_TOL and L within SIM_L_TOL. The R of the duty cycle in % (the voltage before the compare
+ * values were used) is printed next to it.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "../commission.c"
+
+volatile uint8_t SREG, PORTB, DDRB, PORTE, DDRE, EIMSK, EIFR, EICRB ;
+volatile uint16_t OCR3A, OCR3B, OCR3C, ICR3 = PWM_TOP ;
+
+#define SIM_TICK_US 5000 // commission_step() period
+#define SIM_MAX_TICKS 4000 // 20s, the commissioning is over long before
+#define SIM_SAMPLE_PERIOD_US 1000.0 // motor current conversions
+#define SIM_NOISE_MA 50.0
+#define SIM_R_TOL 0.02
+#define SIM_L_TOL 0.05
+#define SIM_OCR_SCALE ((uint32_t)(PWM_TOP*65536UL/100)) // OCR3 counts per % of duty, as in controller.c
+
+typedef struct
+{
+	const char *name ;
+	double r ; // ohm
+	double l ; // H
+	uint16_t u16_vbatt ; // mV
+} SimMotor_t ;
+
+static const SimMotor_t motors[] = {
+	{"RE50_36V", 0.244, 0.000177, 40000},
+	{"RE50_48V", 0.608, 0.000423, 48000},
+	{"RE65_48V", 0.365, 0.000161, 48000}
+} ;
+static const double drops[] = {0.0, 0.3, 0.6} ; // V
+#define SIM_NUM(a) (sizeof(a)/sizeof((a)[0]))
+
+static uint32_t u32_now_us = 0 ;
+static uint32_t u32_rand = 1 ;
+static double sim_r, sim_l, sim_drop, sim_vbatt ;
+static double sim_i = 0.0 ; // A
+static uint8_t b_capture_armed = 0 ;
+static uint16_t u16_capture_value = 0 ;
+static uint32_t u32_capture_time = 0 ;
+static float f32_result_R = 0.0, f32_result_L = 0.0 ;
+
+static double uniform(void) // 0 to 1, the same sequence on every computer
+{
+	u32_rand = u32_rand*1103515245UL + 12345UL ;
+	return (double)((u32_rand >> 8) & 0xFFFF)/65536.0 ;
+}
+
+static double noise_mA(void)
+{
+	return (2.0*uniform()-1.0)*SIM_NOISE_MA ;
+}
+
+static double motor_volt(void) // applied by the last compare values, minus the bridge drop against the current
+{
+	double v = ((double)OCR3A-OCR3B)/PWM_TOP*sim_vbatt ;
+	return (sim_i > 0.0) ? v - sim_drop : v ;
+}
+
+static double steady_current(double v)
+{
+	return (v > 0.0) ? v/sim_r : 0.0 ; // the bridge does not drive the current negative at 0V (UNIPOLAR)
+}
+
+uint32_t systime_us(void)
+{
+	return u32_now_us ;
+}
+
+int16_t current_sensor_mA(uint16_t u16_ADC_reg, uint8_t u8_sensor_num) // the raw value of the capture is in mA here
+{
+	(void)u8_sensor_num ;
+	return (int16_t)u16_ADC_reg ;
+}
+
+void SPI_capture_arm(uint8_t u8_channel) // just after the step, the current is the one of the ZERO phase (none)
+{
+	(void)u8_channel ;
+	double t_load = uniform()*1e6/PWM_FREQ ; // us after the write
+	double t_sample = uniform()*SIM_SAMPLE_PERIOD_US ;
+	double i = 0.0 ;
+	if (t_sample > t_load)
+	{
+		i = steady_current(motor_volt())*(1.0-exp(-(t_sample-t_load)*1e-6*sim_r/sim_l)) ;
+	}
+	double mA = i*1000.0 + noise_mA() ;
+	u16_capture_value = (uint16_t)((mA > 0.0) ? mA + 0.5 : 0.0) ;
+	u32_capture_time = u32_now_us + (uint32_t)t_sample ;
+	b_capture_armed = 1 ;
+}
+
+uint8_t SPI_capture_read(uint16_t *u16_ADC_value, uint32_t *u32_time_us)
+{
+	if (!b_capture_armed)
+	{
+		return 0 ;
+	}
+	*u16_ADC_value = u16_capture_value ;
+	*u32_time_us = u32_capture_time ;
+	b_capture_armed = 0 ;
+	return 1 ;
+}
+
+void controller(volatile ModuleValues_t *vals) // PWM mode of controller.c, UNIPOLAR
+{
+	uint16_t u16_duty_q8 = (uint16_t)vals->u8_duty_cycle << 8 ;
+	OCR3A = (uint16_t)(((uint32_t)u16_duty_q8*SIM_OCR_SCALE) >> 24) ;
+	OCR3B = (uint16_t)(((uint32_t)((100 << 8)-u16_duty_q8)*SIM_OCR_SCALE) >> 24) ;
+}
+
+void controller_set_motor(float f32_res, float f32_ind)
+{
+	f32_result_R = f32_res ;
+	f32_result_L = f32_ind ;
+}
+
+float controller_get_R(void)
+{
+	return f32_result_R ;
+}
+
+float controller_get_L(void)
+{
+	return f32_result_L ;
+}
+
+// one commissioning, returns its status. *nominal_R : R from the duty cycle in % at both points
+static CommissionStatus_t identify(const SimMotor_t *motor, double drop, double *nominal_R)
+{
+	volatile ModuleValues_t vals = {0} ;
+	CommissionStatus_t status = COMMISSION_RUNNING ;
+	uint8_t u8_point_duty[2] = {50, 50} ;
+
+	sim_r = motor->r ;
+	sim_l = motor->l ;
+	sim_drop = drop ;
+	sim_vbatt = motor->u16_vbatt/1000.0 ;
+	sim_i = 0.0 ;
+	u32_now_us = 0 ;
+	b_capture_armed = 0 ;
+	f32_result_R = 0.0 ;
+	f32_result_L = 0.0 ;
+	vals.gear_status = NEUTRAL ;
+	vals.u16_batt_volt = motor->u16_vbatt ;
+	OCR3A = PWM_TOP/2 ;
+	OCR3B = PWM_TOP-OCR3A ;
+	commission_start() ;
+
+	for (int k = 0; k < SIM_MAX_TICKS && status == COMMISSION_RUNNING; k++)
+	{
+		vals.i16_motor_current = (int16_t)(sim_i*1000.0 + noise_mA()) ;
+		if (phase == PHASE_AVERAGE)
+		{
+			u8_point_duty[u8_point] = u8_duty ;
+		}
+		status = commission_step(&vals) ;
+		// over the tick, from the compare values written by commission_step() (the capture is taken meanwhile)
+		double i_ss = steady_current(motor_volt()) ;
+		sim_i = i_ss + (sim_i - i_ss)*exp(-SIM_TICK_US*1e-6*sim_r/sim_l) ;
+		u32_now_us += SIM_TICK_US ;
+	}
+	*nominal_R = (2.0*(u8_point_duty[1]-u8_point_duty[0])/100.0*sim_vbatt)/(f32_I - f32_I1) ;
+	return status ;
+}
+
+int main(void)
+{
+	uint8_t b_fail = 0 ;
+
+	printf("commissioning, R and L identified, errors to the model (R of the duty cycle in %%)\n") ;
+	for (unsigned m = 0; m < SIM_NUM(motors); m++)
+	{
+		for (unsigned d = 0; d < SIM_NUM(drops); d++)
+		{
+			double nominal_R ;
+			CommissionStatus_t status = identify(&motors[m], drops[d], &nominal_R) ;
+			double r_err = f32_result_R/motors[m].r - 1.0 ;
+			double l_err = f32_result_L/motors[m].l - 1.0 ;
+			uint8_t b_ok = (status == COMMISSION_DONE && fabs(r_err) <= SIM_R_TOL && fabs(l_err) <= SIM_L_TOL) ;
+			printf("  %s %.0fV, bridge %.1fV : R %.4f ohm %+5.2f%%, L %5.1f uH %+5.2f%% (duty cycle in %% : R %+5.2f%%)%s\n",
+				motors[m].name, motors[m].u16_vbatt/1000.0, drops[d], f32_result_R, 100.0*r_err, f32_result_L*1e6,
+				100.0*l_err, 100.0*(nominal_R/motors[m].r - 1.0), b_ok ? "" : "  FAILED") ;
+			if (!b_ok)
+			{
+				b_fail = 1 ;
+			}
+		}
+	}
+	return b_fail ;
+}
@@ -0,0 +1,14 @@
+#!/bin/sh
+#
+# commission_sim.sh
+#
+# Host side build and run of commission_sim.c (not part of the firmware) : ./commission_sim.sh
+
+set -e
+cd "$(dirname "$0")"
+OUT="${TMPDIR:-/tmp}/commission_sim"
+CFLAGS="-std=gnu99 -O2 -Wall -Wextra -funsigned-char -fsingle-precision-constant -DF_CPU=8000000UL -Ihost"
+mkdir -p "$OUT"
+
+gcc $CFLAGS -o "$OUT/commission_sim" commission_sim.c -lm
+"$OUT/commission_sim"
@@ -0,0 +1,504 @@
+/*
+ * current_loop_sim.c
+ *
+ * Host side checks (not part of the firmware) of the current loop of controller.c, on a model of the motor.
+ * Build and run on the computer : ./current_loop_sim.sh [test], the exit code is 1 when a check fails.
+ *
+ * controller.c is built once per configuration (see current_loop_variant.c), all of them are linked here.
+ * Motor model : R, L and back-EMF, driven by the duty cycle of OCR3A over the battery voltage (UNIPOLAR), solved
+ * exactly over each loop step. The current is sampled DEADBEAT_SAMPLE_AGE loop steps before the step and given to
+ * the loop in mA, both as the measurement and as the sample (the filter of handle_current_sensor() is not modelled).
+ *
+ * Tests :
+ * equivalence : the fixed point and float loops (feed forward, PI, PWM synchronous) get the same inputs for EQ_STEPS
+ * steps : commands in ACCEL and BRAKE, PI and deadbeat, PWM to current transfers, battery voltage, speed, R and L.
+ * The motor is driven by the fixed point loop. OCR3A and OCR3B of both loops stay within EQ_OCR_TOLERANCE.
+ * feedforward : FF_CMD from coasting at 2 to 6 m/s, at FF_VBATT, fixed point loop with and without feed forward, each
+ * started as by state_handler() (reset_I() or set_I() at the synchronous duty cycle). On the motor model of the loop
+ * and on one with more resistance and back-EMF, the feed forward gets within SIM_BAND no later, with no more IAE and
+ * no higher peak current.
+ * windup : at WINDUP_RELEASE_CMD, WINDUP_CMD (more than reachable at 95%) for WINDUP_TIME, then WINDUP_RELEASE_CMD
+ * again, feed forward, PI and PWM synchronous loops, at 8 to 8.6 m/s on the motor model of the loop and at 7 to 7.6 m/s
+ * on the one with more resistance and back-EMF. The reference is the same loop built with the conditional integration
+ * that back calculation replaced (current_loop_variant.c). The loops get back within SIM_BAND in WINDUP_MAX_MS at most,
+ * no later than the reference, and strictly earlier wherever the integrator of the reference is wound up beyond the
+ * bound by more than WINDUP_WOUND_MIN at the release.
+ * deadbeat : DB_FROM_CMD to DB_CMD at DB_SPEED, 24 to 48V, PWM synchronous and 5ms loops, deadbeat and PI control types.
+ * The deadbeat gets within DB_BAND no later and with no more IAE (DB_IAE_TOL) than the PI, and in a bounded number of
+ * steps.
+ *
+ * Cycles are measured on the board, not here : u16_ctrl_cycles_max in the UART telemetry is the longest controller()
+ * in CPU cycles, timed with timer 1 (SYSTIME_CYCLES_PER_TICK resolution). Flash with and without
+ * CURRENT_LOOP_FIXED_POINT, run the motor in ACCEL and BRAKE, and compare.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../controller.h"
+#include "../powertrain.h"
+
+volatile uint8_t SREG, PORTB, DDRB ;
+volatile uint16_t OCR3A, OCR3B, OCR3C, ICR3 = PWM_TOP ;
+
+#define EQ_STEPS 20000
+#define EQ_SEGMENT 40 // steps with the same inputs
+#define EQ_OCR_TOLERANCE 1 // OCR3 counts, as stated in motor_controller_selection.h
+#define SIM_CURRENT_MAX 32.0 // A, range of i16_motor_current
+#define SIM_BAND 3.0 // A, a step response is settled within that of the command
+// BELT : motor speed and synchronous duty cycle from the car speed in 0.1 m/s (MOTOR_RPM_PER_MM_S_Q16 and DUTY_CALC2 of speed.c)
+#define SIM_RPM_PER_SPEED (6.0*GEAR_RATIO_2/(PI*D_WHEEL))
+#define SIM_DUTY_CALC2 (0.9*6.0*GEAR_RATIO_2/(PI*D_WHEEL*VOLT_SPEED_CST*2))
+#define FF_CMD 10 // A, from coasting
+#define FF_VBATT 40000 // mV
+#define FF_TIME 1.0 // s, both loops get to the one OCR3 count dither of the steady state (peak)
+#define WINDUP_CMD 20 // A, more than the battery can give at these speeds
+#define WINDUP_RELEASE_CMD 2 // A
+#define WINDUP_VBATT 40000 // mV
+#define WINDUP_TIME 0.5 // s, saturated, then as long to get back
+#define WINDUP_MAX_MS 25.0 // back within SIM_BAND, regression bound (PI on the model error : 20.6ms)
+#define WINDUP_WOUND_MIN 1.0 // OCR3 counts, the integrator of the reference is wound up beyond that
+#define DB_FROM_CMD 2 // A, steady before the step
+#define DB_CMD 10 // A
+#define DB_SPEED 30 // 0.1 m/s
+#define DB_TIME 0.2 // s, before and after the step
+#define DB_BAND 1.0 // A
+#define DB_IAE_TOL 1e-6 // A.s, rounding of the sums when both give the same OCR3 values
+
+// the functions of one build of controller.c (see current_loop_variant.c)
+#define SIM_LOOP_API(v) \
+	void v##_controller(volatile ModuleValues_t *vals) ; \
+	void v##_controller_feedforward(volatile ModuleValues_t *vals) ; \
+	void v##_controller_set_motor(float f32_R, float f32_L) ; \
+	void v##_reset_I(void) ; \
+	void v##_set_I(uint8_t duty) ; \
+	extern const float v##_timestep ; \
+	extern const float v##_sample_age ; \
+	extern int32_t v##_windup ;
+#define SIM_LOOP(v, name, ff) {name, ff, v##_controller, v##_controller_feedforward, v##_controller_set_motor, \
+	v##_reset_I, v##_set_I, &v##_timestep, &v##_sample_age, &v##_windup}
+
+SIM_LOOP_API(fx)
+SIM_LOOP_API(fl)
+SIM_LOOP_API(fx_noff)
+SIM_LOOP_API(fl_noff)
+SIM_LOOP_API(fx_sync)
+SIM_LOOP_API(fl_sync)
+SIM_LOOP_API(ci)
+SIM_LOOP_API(ci_noff)
+SIM_LOOP_API(ci_sync)
+
+typedef struct
+{
+	const char *name ;
+	uint8_t b_feedforward ; // CURRENT_LOOP_FEEDFORWARD
+	void (*controller)(volatile ModuleValues_t *vals) ;
+	void (*feedforward)(volatile ModuleValues_t *vals) ;
+	void (*set_motor)(float f32_R, float f32_L) ;
+	void (*reset_I)(void) ;
+	void (*set_I)(uint8_t duty) ;
+	const float *timestep ;
+	const float *sample_age ;
+	int32_t *windup ; // integrator and feed forward beyond the bounds after the last step, Q16.16 % of duty (0 : float)
+} Loop_t ;
+
+static const Loop_t loop_fx = SIM_LOOP(fx, "fixed point, feed forward", 1) ;
+static const Loop_t loop_fl = SIM_LOOP(fl, "float, feed forward", 1) ;
+static const Loop_t loop_fx_noff = SIM_LOOP(fx_noff, "fixed point, PI", 0) ;
+static const Loop_t loop_fl_noff = SIM_LOOP(fl_noff, "float, PI", 0) ;
+static const Loop_t loop_fx_sync = SIM_LOOP(fx_sync, "fixed point, feed forward, PWM synchronous", 1) ;
+static const Loop_t loop_fl_sync = SIM_LOOP(fl_sync, "float, feed forward, PWM synchronous", 1) ;
+static const Loop_t loop_ci = SIM_LOOP(ci, "conditional integration", 1) ;
+static const Loop_t loop_ci_noff = SIM_LOOP(ci_noff, "conditional integration", 0) ;
+static const Loop_t loop_ci_sync = SIM_LOOP(ci_sync, "conditional integration", 1) ;
+
+typedef struct
+{
+	double r, l ; // ohm, H
+	double emf_scale ; // back-EMF over the one of VOLT_SPEED_CST
+	double i ; // A
+	double i_sample ; // A, sampled during the last step
+	double i_ss ; // A, steady state current of the last step
+} Motor_t ;
+
+typedef struct // inputs of controller(), the same for every loop
+{
+	MotorControllerState_t status ;
+	ControlType_t ctrl_type ;
+	uint8_t u8_cmd ; // A, accelerator or brake
+	uint8_t u8_duty ; // % in PWM
+	uint16_t u16_batt_volt ; // mV
+} Inputs_t ;
+
+static uint16_t u16_sim_rpm = 0 ;
+static uint32_t u32_seed = 1 ;
+
+uint16_t motor_speed_estimate(volatile ModuleValues_t *vals) // replaces speed.c : the motor speed of the simulation
+{
+	(void)vals ;
+	return u16_sim_rpm ;
+}
+
+static int sim_rand(int n) // 0..n-1, the same sequence on every computer
+{
+	u32_seed = u32_seed*1103515245UL + 12345 ;
+	return (int)((u32_seed >> 16) % (uint32_t)n) ;
+}
+
+static void motor_step(Motor_t *m, uint16_t u16_ocr, double vbatt, double ts, double sample_age) // one loop step
+{
+	double v = (2.0*u16_ocr/PWM_TOP-1.0)*vbatt - m->emf_scale*u16_sim_rpm/VOLT_SPEED_CST ;
+	double tau = m->l/m->r ;
+	m->i_ss = v/m->r ;
+	m->i_sample = m->i_ss + (m->i - m->i_ss)*exp(-ts*(1.0-sample_age)/tau) ;
+	m->i = m->i_ss + (m->i - m->i_ss)*exp(-ts/tau) ;
+}
+
+static void apply_inputs(volatile ModuleValues_t *vals, const Inputs_t *in, const Motor_t *m)
+{
+	double i_sample = m->i_sample ;
+	if (i_sample > SIM_CURRENT_MAX)
+	{
+		i_sample = SIM_CURRENT_MAX ;
+	}
+	if (i_sample < -SIM_CURRENT_MAX)
+	{
+		i_sample = -SIM_CURRENT_MAX ;
+	}
+	vals->motor_status = in->status ;
+	vals->ctrl_type = in->ctrl_type ;
+	vals->u8_accel_cmd = (in->status == ACCEL) ? in->u8_cmd : 0 ;
+	vals->u16_accel_current = (uint16_t)vals->u8_accel_cmd*1000 ; // TORQUE_SPLIT, all of the command on this motor
+	vals->u8_brake_cmd = (in->status == BRAKE) ? in->u8_cmd : 0 ;
+	if (in->ctrl_type == PWM)
+	{
+		vals->u8_duty_cycle = in->u8_duty ;
+	}
+	vals->u16_batt_volt = in->u16_batt_volt ;
+	vals->i16_motor_current = (int16_t)lround(i_sample*1000.0) ;
+	vals->i16_motor_current_sample = vals->i16_motor_current ;
+}
+
+static int test_equivalence_of(const Loop_t *fixed, const Loop_t *flt)
+{
+	volatile ModuleValues_t v_fixed = {0}, v_float = {0} ;
+	Motor_t m = {R, L, 1.0, 0.0, 0.0, 0.0} ;
+	Inputs_t in = {IDLE, CURRENT, 0, 50, 40000} ;
+	int max_diff = 0, diff_steps = 0 ;
+
+	u32_seed = 1 ;
+	fixed->set_motor(R, L) ;
+	flt->set_motor(R, L) ;
+	for (int k = 0; k < EQ_STEPS; k++)
+	{
+		if (k % EQ_SEGMENT == 0) // new inputs, with the transitions of the state machine
+		{
+			int draw = sim_rand(10) ;
+			MotorControllerState_t last = in.status ;
+			in.u16_batt_volt = (uint16_t)(20000 + sim_rand(35001)) ;
+			u16_sim_rpm = (uint16_t)sim_rand(4001) ;
+			if (draw < 6)
+			{
+				in.status = ACCEL ;
+				in.u8_cmd = (uint8_t)sim_rand(21) ;
+			}else if (draw < 9)
+			{
+				in.status = BRAKE ;
+				in.u8_cmd = (uint8_t)sim_rand(11) ;
+			}else{
+				in.status = ENGAGE ; // PWM, the next current step is a bumpless transfer
+				in.u8_duty = (uint8_t)(50 + 50.0*u16_sim_rpm/VOLT_SPEED_CST/(in.u16_batt_volt/1000.0)) + sim_rand(5) ;
+			}
+			in.ctrl_type = (in.status == ENGAGE) ? PWM : (sim_rand(2) ? DEADBEAT : CURRENT) ;
+			if (last != ENGAGE && in.status != last) // from IDLE, as in state_handler()
+			{
+				if (sim_rand(2))
+				{
+					fixed->reset_I() ;
+					flt->reset_I() ;
+				}else{
+					uint8_t u8_duty = (uint8_t)(50 + sim_rand(30)) ;
+					fixed->set_I(u8_duty) ;
+					flt->set_I(u8_duty) ;
+				}
+			}
+			if (k % (10*EQ_SEGMENT) == 0) // commissioning results, then IDLE (the float integrator is in A.s, not in duty)
+			{
+				m.r = R*(0.7 + 0.6*sim_rand(101)/100.0) ;
+				m.l = L*(0.7 + 0.6*sim_rand(101)/100.0) ;
+				fixed->set_motor((float)m.r, (float)m.l) ;
+				flt->set_motor((float)m.r, (float)m.l) ;
+				fixed->reset_I() ;
+				flt->reset_I() ;
+			}
+		}
+
+		apply_inputs(&v_fixed, &in, &m) ;
+		apply_inputs(&v_float, &in, &m) ;
+		fixed->feedforward(&v_fixed) ;
+		flt->feedforward(&v_float) ;
+		flt->controller(&v_float) ;
+		int a_float = OCR3A, b_float = OCR3B ;
+		fixed->controller(&v_fixed) ;
+		int diff = abs((int)OCR3A - a_float) ;
+		if (abs((int)OCR3B - b_float) > diff)
+		{
+			diff = abs((int)OCR3B - b_float) ;
+		}
+		if (diff > max_diff)
+		{
+			max_diff = diff ;
+		}
+		if (diff > 0)
+		{
+			diff_steps ++ ;
+		}
+		motor_step(&m, OCR3A, in.u16_batt_volt/1000.0, *fixed->timestep, *fixed->sample_age) ;
+	}
+
+	printf("  %s / %s : %d steps, %d with another OCR3 value, %d count(s) max\n", fixed->name, flt->name, EQ_STEPS,
+		diff_steps, max_diff) ;
+	return (max_diff <= EQ_OCR_TOLERANCE) ;
+}
+
+static int test_equivalence(void)
+{
+	int ok = test_equivalence_of(&loop_fx, &loop_fl) ;
+	ok &= test_equivalence_of(&loop_fx_noff, &loop_fl_noff) ;
+	ok &= test_equivalence_of(&loop_fx_sync, &loop_fl_sync) ;
+	return ok ;
+}
+
+typedef struct
+{
+	int steps ; // loop steps until the current is within SIM_BAND of the command, -1 : never
+	double in_ms ; // ms until then, to the crossing within the step (exponential of motor_step()), -1 : never
+	double settled_ms ; // ms from which it stays within SIM_BAND, -1 : not at the end
+	double iae ; // A.s, integral of the absolute current error
+	double peak ; // A
+} Response_t ;
+
+static void start_accel(const Loop_t *loop, volatile ModuleValues_t *vals, const Inputs_t *in, const Motor_t *m,
+	uint8_t u8_speed) // IDLE to ACCEL, as in state_handler() for BELT, car speed in 0.1 m/s
+{
+	u16_sim_rpm = (uint16_t)(u8_speed*SIM_RPM_PER_SPEED) ;
+	apply_inputs(vals, in, m) ;
+	loop->feedforward(vals) ;
+	if (loop->b_feedforward)
+	{
+		loop->reset_I() ;
+	}else{
+		loop->set_I((uint8_t)(u8_speed*SIM_DUTY_CALC2/(in->u16_batt_volt/1000.0)*100 + 50)) ;
+	}
+}
+
+static double band_crossing(const Motor_t *m, double i0, double cmd, double band, double ts) // share of the last step
+{
+	if (fabs(i0 - cmd) < band)
+	{
+		return 0.0 ;
+	}
+	double edge = (i0 > cmd) ? cmd + band : cmd - band ;
+	return m->l/m->r*log((i0 - m->i_ss)/(edge - m->i_ss))/ts ;
+}
+
+static void run_steps(const Loop_t *loop, volatile ModuleValues_t *vals, const Inputs_t *in, Motor_t *m, int n,
+	double band, Response_t *r) // n loop steps with the same inputs, response to the command in->u8_cmd within band (A)
+{
+	double ts = *loop->timestep ;
+	r->steps = -1 ;
+	r->in_ms = -1.0 ;
+	r->settled_ms = -1.0 ;
+	r->iae = 0.0 ;
+	r->peak = 0.0 ;
+	for (int k = 0; k < n; k++)
+	{
+		double i0 = m->i ;
+		apply_inputs(vals, in, m) ;
+		loop->feedforward(vals) ;
+		loop->controller(vals) ;
+		motor_step(m, OCR3A, in->u16_batt_volt/1000.0, ts, *loop->sample_age) ;
+		double err = fabs(m->i - in->u8_cmd) ;
+		r->iae += err*ts ;
+		if (r->steps < 0 && err < band)
+		{
+			r->steps = k+1 ;
+			r->in_ms = (k + band_crossing(m, i0, in->u8_cmd, band, ts))*ts*1000.0 ;
+		}
+		if (err >= band)
+		{
+			r->settled_ms = -1.0 ;
+		}else if (r->settled_ms < 0)
+		{
+			r->settled_ms = (k + band_crossing(m, i0, in->u8_cmd, band, ts))*ts*1000.0 ;
+		}
+		if (m->i > r->peak)
+		{
+			r->peak = m->i ;
+		}
+	}
+}
+
+static double response_ms(const Loop_t *loop, const Response_t *r)
+{
+	return (r->steps < 0) ? -1.0 : r->steps*(*loop->timestep)*1000.0 ;
+}
+
+static void step_from_coasting(const Loop_t *loop, const Motor_t *motor, uint8_t u8_speed, Response_t *r)
+{
+	volatile ModuleValues_t vals = {0} ;
+	Motor_t m = *motor ;
+	Inputs_t in = {ACCEL, CURRENT, FF_CMD, 50, FF_VBATT} ;
+	loop->set_motor(R, L) ;
+	start_accel(loop, &vals, &in, &m, u8_speed) ;
+	run_steps(loop, &vals, &in, &m, (int)(FF_TIME/(*loop->timestep)), SIM_BAND, r) ;
+}
+
+static int test_feedforward(void)
+{
+	const Motor_t motors[2] = {
+		{R, L, 1.0, 0.0, 0.0, 0.0}, // the model of the loop
+		{1.3*R, L, 1.1, 0.0, 0.0, 0.0} // 30% more resistance and 10% more back-EMF than the model
+	} ;
+	int ok = 1 ;
+	for (int e = 0; e < 2; e++)
+	{
+		for (uint8_t u8_speed = 20; u8_speed <= 60; u8_speed += 10)
+		{
+			Response_t ff, pi ;
+			step_from_coasting(&loop_fx, &motors[e], u8_speed, &ff) ;
+			step_from_coasting(&loop_fx_noff, &motors[e], u8_speed, &pi) ;
+			printf("  %s, %.1f m/s : feed forward %3.0f ms, IAE %.3f A.s, peak %4.1f A / PI %3.0f ms, IAE %.3f A.s, peak %4.1f A\n",
+				e ? "model error" : "exact model", u8_speed/10.0, response_ms(&loop_fx, &ff), ff.iae, ff.peak,
+				response_ms(&loop_fx_noff, &pi), pi.iae, pi.peak) ;
+			ok &= (ff.steps >= 0 && (pi.steps < 0 || ff.steps <= pi.steps) && ff.iae <= pi.iae && ff.peak <= pi.peak) ;
+		}
+	}
+	return ok ;
+}
+
+// WINDUP_RELEASE_CMD, WINDUP_CMD (saturated), then WINDUP_RELEASE_CMD again, r is the response to the release.
+// Returns the windup at the release : the integrator and the feed forward beyond the bound, in OCR3 counts
+static double windup_release(const Loop_t *loop, const Motor_t *motor, uint8_t u8_speed, Response_t *r)
+{
+	volatile ModuleValues_t vals = {0} ;
+	Motor_t m = *motor ;
+	Inputs_t in = {ACCEL, CURRENT, WINDUP_RELEASE_CMD, 50, WINDUP_VBATT} ;
+	int n = (int)(WINDUP_TIME/(*loop->timestep)) ;
+	loop->set_motor(R, L) ;
+	start_accel(loop, &vals, &in, &m, u8_speed) ;
+	run_steps(loop, &vals, &in, &m, n, SIM_BAND, r) ;
+	in.u8_cmd = WINDUP_CMD ;
+	run_steps(loop, &vals, &in, &m, n, SIM_BAND, r) ;
+	double windup = *loop->windup/65536.0*PWM_TOP/100.0 ;
+	in.u8_cmd = WINDUP_RELEASE_CMD ;
+	run_steps(loop, &vals, &in, &m, n, SIM_BAND, r) ;
+	return windup ;
+}
+
+static int test_windup_of(const Loop_t *loop, const Loop_t *ref)
+{
+	const Motor_t motors[2] = {
+		{R, L, 1.0, 0.0, 0.0, 0.0},
+		{1.3*R, L, 1.1, 0.0, 0.0, 0.0}
+	} ;
+	int ok = 1 ;
+	for (int e = 0; e < 2; e++)
+	{
+		for (uint8_t u8_speed = 80-10*e; u8_speed <= 86-10*e; u8_speed += 2)
+		{
+			Response_t r, r_ref ;
+			double wound = windup_release(loop, &motors[e], u8_speed, &r) ;
+			double wound_ref = windup_release(ref, &motors[e], u8_speed, &r_ref) ;
+			uint8_t b_wound = (wound_ref > WINDUP_WOUND_MIN) ;
+			printf("  %s, %s, %.1f m/s : %5.2f ms, settled %5.2f ms, wound %.1f / %s %5.2f ms, settled %5.2f ms, wound %.1f\n",
+				loop->name, e ? "model error" : "exact model", u8_speed/10.0, r.in_ms, r.settled_ms, wound, ref->name,
+				r_ref.in_ms, r_ref.settled_ms, wound_ref) ;
+			ok &= (r.steps >= 0 && r.in_ms <= WINDUP_MAX_MS) ;
+			ok &= (r_ref.steps < 0 || (b_wound ? r.in_ms < r_ref.in_ms : r.in_ms <= r_ref.in_ms)) ;
+		}
+	}
+	return ok ;
+}
+
+static int test_windup(void)
+{
+	int ok = test_windup_of(&loop_fx, &loop_ci) ;
+	ok &= test_windup_of(&loop_fx_noff, &loop_ci_noff) ;
+	ok &= test_windup_of(&loop_fx_sync, &loop_ci_sync) ;
+	return ok ;
+}
+
+static void deadbeat_step(const Loop_t *loop, ControlType_t ctrl_type, uint16_t u16_vbatt, Response_t *r)
+{
+	volatile ModuleValues_t vals = {0} ;
+	Motor_t m = {R, L, 1.0, 0.0, 0.0, 0.0} ;
+	Inputs_t in = {ACCEL, ctrl_type, DB_FROM_CMD, 50, u16_vbatt} ;
+	int n = (int)(DB_TIME/(*loop->timestep)) ;
+	loop->set_motor(R, L) ;
+	start_accel(loop, &vals, &in, &m, DB_SPEED) ;
+	run_steps(loop, &vals, &in, &m, n, DB_BAND, r) ;
+	in.u8_cmd = DB_CMD ;
+	run_steps(loop, &vals, &in, &m, n, DB_BAND, r) ;
+}
+
+static int test_deadbeat_of(const Loop_t *loop, int max_steps) // deadbeat within DB_BAND in max_steps, regression bound
+{
+	int ok = 1 ;
+	for (uint16_t u16_vbatt = 24000; u16_vbatt <= 48000; u16_vbatt += 12000)
+	{
+		Response_t db, pi ;
+		deadbeat_step(loop, DEADBEAT, u16_vbatt, &db) ;
+		deadbeat_step(loop, CURRENT, u16_vbatt, &pi) ;
+		printf("  %s, %2u V : deadbeat %2d steps, IAE %.4f A.s, peak %4.1f A / PI %2d steps, IAE %.4f A.s, peak %4.1f A\n",
+			loop->name, u16_vbatt/1000, db.steps, db.iae, db.peak, pi.steps, pi.iae, pi.peak) ;
+		ok &= (db.steps >= 0 && db.steps <= max_steps && (pi.steps < 0 || db.steps <= pi.steps) && db.iae <= pi.iae + DB_IAE_TOL) ;
+	}
+	return ok ;
+}
+
+static int test_deadbeat(void)
+{
+	int ok = test_deadbeat_of(&loop_fx_sync, 2) ;
+	ok &= test_deadbeat_of(&loop_fx, 5) ;
+	return ok ;
+}
+
+typedef struct
+{
+	const char *name ;
+	int (*run)(void) ; // 0 : failed
+} Test_t ;
+
+static const Test_t tests[] = {
+	{"equivalence", test_equivalence},
+	{"feedforward", test_feedforward},
+	{"windup", test_windup},
+	{"deadbeat", test_deadbeat}
+} ;
+
+int main(int argc, char **argv)
+{
+	int failed = 0, found = 0 ;
+	for (unsigned t = 0; t < sizeof(tests)/sizeof(tests[0]); t++)
+	{
+		if (argc > 1 && strcmp(argv[1], tests[t].name) != 0)
+		{
+			continue ;
+		}
+		found = 1 ;
+		printf("%s\n", tests[t].name) ;
+		if (!tests[t].run())
+		{
+			printf("  FAILED\n") ;
+			failed = 1 ;
+		}
+	}
+	if (!found)
+	{
+		fprintf(stderr, "no test %s\n", argv[1]) ;
+		return 1 ;
+	}
+	return failed ;
+}
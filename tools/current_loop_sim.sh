@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+# current_loop_sim.sh
+#
+# Host side build and run of current_loop_sim.c (not part of the firmware) : ./current_loop_sim.sh [test]
+# controller.c is built once per configuration of the current loop (see current_loop_variant.c).
+# -fsingle-precision-constant : double is float on the AVR, the float loop is computed in single precision.
+
+set -e
+cd "$(dirname "$0")"
+OUT="${TMPDIR:-/tmp}/current_loop_sim"
+CFLAGS="-std=gnu99 -O2 -Wall -Wextra -funsigned-char -fsingle-precision-constant -DF_CPU=8000000UL -Ihost"
+mkdir -p "$OUT"
+
+variant()
+{
+	name=$1
+	shift
+	gcc $CFLAGS -DSIM_VARIANT=$name "$@" -c current_loop_variant.c -o "$OUT/$name.o"
+	OBJS="$OBJS $OUT/$name.o"
+}
+
+OBJS=""
+variant fx
+variant fl -DSIM_FLOAT
+variant fx_noff -DSIM_NO_FEEDFORWARD
+variant fl_noff -DSIM_FLOAT -DSIM_NO_FEEDFORWARD
+variant fx_sync -DSIM_PWM_SYNC
+variant fl_sync -DSIM_FLOAT -DSIM_PWM_SYNC
+variant ci -DSIM_CONDITIONAL_INTEGRATION
+variant ci_noff -DSIM_CONDITIONAL_INTEGRATION -DSIM_NO_FEEDFORWARD
+variant ci_sync -DSIM_CONDITIONAL_INTEGRATION -DSIM_PWM_SYNC
+gcc $CFLAGS -o "$OUT/current_loop_sim" current_loop_sim.c ../pid.c $OBJS -lm
+"$OUT/current_loop_sim" "$@"
@@ -0,0 +1,84 @@
+/*
+ * current_loop_variant.c
+ *
+ * Host side (not part of the firmware) : controller.c built with one configuration of the current loop, for the
+ * simulations of current_loop_sim.c. Built once per configuration by current_loop_sim.sh, with :
+ * -DSIM_VARIANT=name : the public functions of controller.c are renamed name_xxx (see SIM_LOOP_API in current_loop_sim.c)
+ * -DSIM_FLOAT : float loop instead of the fixed point one
+ * -DSIM_NO_FEEDFORWARD : pure PI
+ * -DSIM_PWM_SYNC : PWM synchronous time step (CURRENT_LOOP_PWM_DIVISOR PWM periods), also with the float loop
+ * -DSIM_CONDITIONAL_INTEGRATION : fixed point loop, with the anti windup it had before back calculation (reference of
+ *  the windup test) : the integrator is frozen while the last duty cycle is at a bound
+ * The other settings are the ones of motor_controller_selection.h and controller.h.
+ */
+
+#include "../motor_controller_selection.h"
+
+#undef CURRENT_LOOP_FIXED_POINT
+#undef CURRENT_LOOP_FEEDFORWARD
+#undef CURRENT_LOOP_PWM_SYNC
+#ifndef SIM_FLOAT
+#define CURRENT_LOOP_FIXED_POINT
+#endif
+#ifndef SIM_NO_FEEDFORWARD
+#define CURRENT_LOOP_FEEDFORWARD
+#endif
+#ifdef SIM_PWM_SYNC
+#define CURRENT_LOOP_PWM_SYNC
+#endif
+#if defined(SIM_PWM_SYNC) && defined(SIM_FLOAT)
+// CURRENT_LOOP_PWM_SYNC requires the fixed point loop (ISR time) : controller.h is read with it, controller.c without
+#define CURRENT_LOOP_FIXED_POINT
+#include "../controller.h"
+#undef CURRENT_LOOP_FIXED_POINT
+#endif
+
+#define SIM_PASTE(v, f) v##_##f
+#define SIM_NAME(v, f) SIM_PASTE(v, f)
+
+// integrator and feed forward beyond the bounds after the last step, the P term left out (Q16.16 % of duty, fixed point)
+int32_t SIM_NAME(SIM_VARIANT, windup) = 0 ;
+#ifndef SIM_FLOAT
+#include "../pid.h"
+static inline int32_t sim_pid_update(Pid_t *PID, int16_t i16_setpoint, int16_t i16_meas, int32_t i32_ff)
+{
+	int16_t i16_KiTs = PID->i16_KiTs ;
+	uint16_t u16_KtTs = PID->u16_KtTs ;
+	int32_t i32_out ;
+#ifdef SIM_CONDITIONAL_INTEGRATION
+	static int32_t i32_last_out = 0 ;
+	if (i32_last_out >= PID->i32_out_max || i32_last_out <= PID->i32_out_min)
+	{
+		PID->i16_KiTs = 0 ;
+	}
+	PID->u16_KtTs = 0 ;
+#endif
+	i32_out = pid_update(PID, i16_setpoint, i16_meas, i32_ff) ;
+	PID->i16_KiTs = i16_KiTs ;
+	PID->u16_KtTs = u16_KtTs ;
+#ifdef SIM_CONDITIONAL_INTEGRATION
+	i32_last_out = i32_out ;
+#endif
+	int32_t i32_unbounded = PID->i32_integrator + i32_ff ;
+	SIM_NAME(SIM_VARIANT, windup) = (i32_unbounded > PID->i32_out_max) ? i32_unbounded - PID->i32_out_max
+		: ((i32_unbounded < PID->i32_out_min) ? i32_unbounded - PID->i32_out_min : 0) ;
+	return i32_out ;
+}
+#define pid_update sim_pid_update
+#endif
+#define controller SIM_NAME(SIM_VARIANT, controller)
+#define controller_feedforward SIM_NAME(SIM_VARIANT, controller_feedforward)
+#define controller_set_motor SIM_NAME(SIM_VARIANT, controller_set_motor)
+#define controller_get_R SIM_NAME(SIM_VARIANT, controller_get_R)
+#define controller_get_L SIM_NAME(SIM_VARIANT, controller_get_L)
+#define reset_I SIM_NAME(SIM_VARIANT, reset_I)
+#define set_I SIM_NAME(SIM_VARIANT, set_I)
+#define drivers SIM_NAME(SIM_VARIANT, drivers)
+#define drivers_init SIM_NAME(SIM_VARIANT, drivers_init)
+#define TimeStep SIM_NAME(SIM_VARIANT, TimeStep)
+#define KtTs SIM_NAME(SIM_VARIANT, KtTs)
+
+#include "../controller.c"
+
+const float SIM_NAME(SIM_VARIANT, timestep) = CONTROLLER_TIMESTEP ; // s
+const float SIM_NAME(SIM_VARIANT, sample_age) = DEADBEAT_SAMPLE_AGE ; // age of the current sample at the loop step, in steps
@@ -0,0 +1,169 @@
+/*
+ * efficiency_learn_merge.c
+ *
+ * Host side converter (not part of the firmware) of the learned efficiency cells exported by efficiency.c to the input
+ * of tools/efficiency_map_gen.c, so that the learning gets into the static maps and the torque split table.
+ * Build and run on the computer : gcc -o efficiency_learn_merge efficiency_learn_merge.c -lm && ./efficiency_learn_merge 1 motor1_efficiency.csv motor1_learned.txt > motor1_merged.csv
+ *
+ * Arguments : the motor (1 or 2, for its torque constant in powertrain.h), its efficiency CSV (rpm,torque_mNm,efficiency
+ * on a full grid, see efficiency_map_gen.c) and the UART log of the export (EFFICIENCY_EXPORT_UART_CMD). The lines
+ * "eff,rpm,mA,learned,map,J" of the log are read wherever they are, the other ones are skipped.
+ * The cells (LEARN_x of efficiency.h, read as text) have to be all there. Each point of the CSV is moved towards the
+ * learned efficiency of its cell as by merged_efficiency() : same cell, weight J/LEARN_FULL_J up to 1. The output is
+ * the same grid, the CSV of the round trip :
+ *  1. UART EFFICIENCY_EXPORT_UART_CMD on each controller, log to motor1_learned.txt and motor2_learned.txt
+ *  2. this converter for each motor, into motor1_merged.csv and motor2_merged.csv
+ *  3. ./efficiency_map_gen motor1_merged.csv motor2_merged.csv > ../motorefficiencies.h
+ *  4. ./torque_split_table_gen ../motorefficiencies.h > ../torque_split_table.h
+ *  5. program both controllers, then UART EFFICIENCY_RESET_UART_CMD on each : the cells are in the maps now, kept
+ *     they would be counted twice. The merged CSV replaces motorx_efficiency.csv for the next round.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../powertrain.h"
+
+#define MAX_CELLS 256
+
+static long learn_rpm_cell, learn_rpm_cells, learn_ma_cell, learn_ma_cells, learn_full_j ;
+static int learned[MAX_CELLS] ;
+static double weight[MAX_CELLS] ;
+static unsigned char exported[MAX_CELLS] ;
+
+static int read_define(const char *text, const char *name, long *value) // 0 if not found
+{
+	char key[64] ;
+	snprintf(key, sizeof(key), "#define %s ", name) ;
+	const char *p = strstr(text, key) ;
+	if (p == NULL)
+	{
+		return 0 ;
+	}
+	*value = strtol(p+strlen(key), NULL, 10) ;
+	return *value > 0 ;
+}
+
+static int read_learn_constants(const char *path) // 0 if not found
+{
+	static char text[1 << 16] ;
+	FILE *f = fopen(path, "r") ;
+	if (f == NULL)
+	{
+		return 0 ;
+	}
+	text[fread(text, 1, sizeof(text)-1, f)] = '\0' ;
+	fclose(f) ;
+	return read_define(text, "LEARN_RPM_CELL", &learn_rpm_cell) && read_define(text, "LEARN_RPM_CELLS", &learn_rpm_cells)
+		&& read_define(text, "LEARN_MA_CELL", &learn_ma_cell) && read_define(text, "LEARN_MA_CELLS", &learn_ma_cells)
+		&& read_define(text, "LEARN_FULL_J", &learn_full_j) && learn_rpm_cells*learn_ma_cells <= MAX_CELLS ;
+}
+
+static int read_export(const char *path) // number of cells, 0 if a line is not one of the grid
+{
+	char line[256] ;
+	int count = 0 ;
+	FILE *f = fopen(path, "r") ;
+	if (f == NULL)
+	{
+		fprintf(stderr, "%s : cannot open\n", path) ;
+		return 0 ;
+	}
+	memset(exported, 0, sizeof(exported)) ;
+	while (fgets(line, sizeof(line), f) != NULL)
+	{
+		unsigned rpm, mA, eff, map ;
+		unsigned long j ;
+		const char *p = strstr(line, "eff,") ;
+		if (p == NULL || sscanf(p, "eff,%u,%u,%u,%u,%lu", &rpm, &mA, &eff, &map, &j) != 5)
+		{
+			continue ;
+		}
+		long row = rpm/learn_rpm_cell ;
+		long col = mA/learn_ma_cell ;
+		if (row >= learn_rpm_cells || col >= learn_ma_cells || rpm != row*learn_rpm_cell+learn_rpm_cell/2 || mA != col*learn_ma_cell+learn_ma_cell/2 || eff > 100)
+		{
+			fprintf(stderr, "%s : %u rpm, %u mA is not the centre of a cell of efficiency.h\n", path, rpm, mA) ;
+			fclose(f) ;
+			return 0 ;
+		}
+		int cell = (int)(row*learn_ma_cells+col) ;
+		count += !exported[cell] ;
+		exported[cell] = 1 ;
+		learned[cell] = (int)eff ;
+		weight[cell] = ((long)j >= learn_full_j) ? 1.0 : (double)j/learn_full_j ;
+	}
+	fclose(f) ;
+	return count ;
+}
+
+int main(int argc, char **argv)
+{
+	char line[256] ;
+	int points = 0 ;
+	int moved = 0 ;
+	double max_change = 0.0 ;
+
+	if (argc != 4 || (strcmp(argv[1], "1") != 0 && strcmp(argv[1], "2") != 0))
+	{
+		fprintf(stderr, "usage : efficiency_learn_merge motor(1 or 2) efficiency.csv export.txt > merged.csv\n") ;
+		return 1 ;
+	}
+	// torque to current as in merged_efficiency()
+	unsigned long kt_q8 = (unsigned long)(((argv[1][0] == '1') ? KT_MOTOR1 : KT_MOTOR2)*256.0+0.5) ;
+	if (!read_learn_constants("../efficiency.h"))
+	{
+		fprintf(stderr, "../efficiency.h : cannot read the LEARN_ constants\n") ;
+		return 1 ;
+	}
+	if (read_export(argv[3]) != learn_rpm_cells*learn_ma_cells)
+	{
+		fprintf(stderr, "%s : the export has to hold the %ld cells\n", argv[3], learn_rpm_cells*learn_ma_cells) ;
+		return 1 ;
+	}
+	FILE *f = fopen(argv[2], "r") ;
+	if (f == NULL)
+	{
+		fprintf(stderr, "%s : cannot open\n", argv[2]) ;
+		return 1 ;
+	}
+
+	while (fgets(line, sizeof(line), f) != NULL)
+	{
+		int rpm, torque ;
+		double eff ;
+		if (line[0] == '#')
+		{
+			fputs(line, stdout) ; // the description of the data is kept
+			continue ;
+		}
+		if (sscanf(line, "%d,%d,%lf", &rpm, &torque, &eff) != 3 || rpm < 0 || torque < 0)
+		{
+			continue ; // header or empty line
+		}
+		if (points++ == 0)
+		{
+			printf("# merged with the learned efficiency of %s by tools/efficiency_learn_merge.c\n", argv[3]) ;
+			printf("rpm,torque_mNm,efficiency\n") ;
+		}
+		long row = rpm/learn_rpm_cell ;
+		long col = (long)((unsigned long)torque*256000UL/kt_q8/learn_ma_cell) ;
+		int cell = (int)(((row < learn_rpm_cells) ? row : learn_rpm_cells-1)*learn_ma_cells + ((col < learn_ma_cells) ? col : learn_ma_cells-1)) ;
+		double merged = eff*(1.0-weight[cell]) + learned[cell]*weight[cell] ;
+		if (fabs(merged-eff) >= 0.05)
+		{
+			moved++ ;
+			max_change = (fabs(merged-eff) > max_change) ? fabs(merged-eff) : max_change ;
+		}
+		printf("%d,%d,%.1f\n", rpm, torque, merged) ;
+	}
+	fclose(f) ;
+	if (points == 0)
+	{
+		fprintf(stderr, "%s : no data\n", argv[2]) ;
+		return 1 ;
+	}
+	fprintf(stderr, "%d points, %d moved by the learning, %.1f %% at most\n", points, moved, max_change) ;
+	return 0 ;
+}
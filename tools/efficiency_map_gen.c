@@ -0,0 +1,263 @@
+/*
+ * efficiency_map_gen.c
+ *
+ * Host side generator (not part of the firmware) of motorefficiencies.h, used by efficiency.c
+ * Build and run on the computer : gcc -o efficiency_map_gen efficiency_map_gen.c -lm && ./efficiency_map_gen motor1_efficiency.csv motor2_efficiency.csv > ../motorefficiencies.h
+ *
+ * Input : one CSV per motor (dyno data), lines "rpm,torque_mNm,efficiency" with the efficiency in %, on a full grid
+ * (every rpm with every torque, in any order). Lines starting with # and the header line are skipped.
+ * The efficiency learned by the controllers is merged into these CSV by tools/efficiency_learn_merge.c.
+ * The maps are named motor1, motor2... in the order of the files.
+ * Output : the breakpoints of each axis and the efficiency at them, for the bilinear interpolation of
+ * efficiency_interp(). The breakpoints are chosen so that the linear interpolation along each axis stays within
+ * MAP_TOLERANCE of the data, the error of the bilinear interpolation (same arithmetic as efficiency_interp())
+ * over all the data points is written in the header.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MAP_TOLERANCE 1.0 // %, along one axis
+#define MAX_MAPS 8
+#define MAX_POINTS 256 // data points per axis, and breakpoints
+
+typedef struct
+{
+	int rpm_count, torque_count ;
+	int rpm[MAX_POINTS], torque[MAX_POINTS] ;
+	double eff[MAX_POINTS][MAX_POINTS] ; // data, [rpm][torque]
+	int rpm_bp_count, torque_bp_count ;
+	int rpm_bp[MAX_POINTS], torque_bp[MAX_POINTS] ; // indexes of the data points kept
+	int max_rpm_step, max_torque_step ;
+} Map_t ;
+
+static Map_t maps[MAX_MAPS] ;
+
+static int index_of(int *values, int *count, int value) // sorted insertion
+{
+	int i = 0 ;
+	while (i < *count && values[i] < value)
+	{
+		i++ ;
+	}
+	if (i < *count && values[i] == value)
+	{
+		return i ;
+	}
+	if (*count == MAX_POINTS)
+	{
+		return -1 ;
+	}
+	memmove(&values[i+1], &values[i], (size_t)(*count-i)*sizeof(int)) ;
+	(*count)++ ;
+	values[i] = value ;
+	return i ;
+}
+
+static int read_csv(const char *path, Map_t *map) // 0 on error, with a message
+{
+	static int rpm[MAX_POINTS*MAX_POINTS], torque[MAX_POINTS*MAX_POINTS] ;
+	static double eff[MAX_POINTS*MAX_POINTS] ;
+	static unsigned char filled[MAX_POINTS][MAX_POINTS] ;
+	char line[256] ;
+	int n = 0 ;
+	FILE *f = fopen(path, "r") ;
+	if (f == NULL)
+	{
+		fprintf(stderr, "%s : cannot open\n", path) ;
+		return 0 ;
+	}
+	map->rpm_count = 0 ;
+	map->torque_count = 0 ;
+	while (fgets(line, sizeof(line), f) != NULL)
+	{
+		if (line[0] == '#' || sscanf(line, "%d,%d,%lf", &rpm[n], &torque[n], &eff[n]) != 3)
+		{
+			continue ; // comment, header or empty line
+		}
+		if (index_of(map->rpm, &map->rpm_count, rpm[n]) < 0 || index_of(map->torque, &map->torque_count, torque[n]) < 0 || rpm[n] < 0 || rpm[n] > 0xFFFF || torque[n] < 0 || torque[n] > 0xFFFF)
+		{
+			fprintf(stderr, "%s : more than %d values of an axis, or out of 0..65535\n", path, MAX_POINTS) ;
+			fclose(f) ;
+			return 0 ;
+		}
+		if (++n == MAX_POINTS*MAX_POINTS)
+		{
+			break ;
+		}
+	}
+	fclose(f) ;
+	memset(filled, 0, sizeof(filled)) ;
+	for (int i = 0; i < n; i++)
+	{
+		int r = index_of(map->rpm, &map->rpm_count, rpm[i]) ;
+		int t = index_of(map->torque, &map->torque_count, torque[i]) ;
+		map->eff[r][t] = eff[i] ;
+		filled[r][t] = 1 ;
+	}
+	for (int r = 0; r < map->rpm_count; r++)
+	{
+		for (int t = 0; t < map->torque_count; t++)
+		{
+			if (!filled[r][t])
+			{
+				fprintf(stderr, "%s : no point at %d rpm, %d mNm, the grid has to be full\n", path, map->rpm[r], map->torque[t]) ;
+				return 0 ;
+			}
+		}
+	}
+	if (map->rpm_count < 2 || map->torque_count < 2)
+	{
+		fprintf(stderr, "%s : at least 2 values of each axis\n", path) ;
+		return 0 ;
+	}
+	return 1 ;
+}
+
+static double data(Map_t *map, int b_rpm_axis, int other, int i) // data point i along an axis, at the point other of the other axis
+{
+	return b_rpm_axis ? map->eff[i][other] : map->eff[other][i] ;
+}
+
+static int choose_breakpoints(Map_t *map, int b_rpm_axis, int *bp) // greedy : each segment as long as the linear interpolation holds
+{
+	int *values = b_rpm_axis ? map->rpm : map->torque ;
+	int count = b_rpm_axis ? map->rpm_count : map->torque_count ;
+	int others = b_rpm_axis ? map->torque_count : map->rpm_count ;
+	int bp_count = 1 ;
+	int start = 0 ;
+	bp[0] = 0 ;
+	while (start < count-1)
+	{
+		int end = start+1 ;
+		for (int next = end+1; next < count; next++)
+		{
+			int b_ok = 1 ;
+			for (int o = 0; o < others && b_ok; o++)
+			{
+				for (int i = start+1; i < next && b_ok; i++)
+				{
+					double lin = data(map, b_rpm_axis, o, start) + (data(map, b_rpm_axis, o, next)-data(map, b_rpm_axis, o, start))*(values[i]-values[start])/(values[next]-values[start]) ;
+					b_ok = (fabs(lin-data(map, b_rpm_axis, o, i)) <= MAP_TOLERANCE) ;
+				}
+			}
+			if (!b_ok)
+			{
+				break ;
+			}
+			end = next ;
+		}
+		bp[bp_count++] = end ;
+		start = end ;
+	}
+	return bp_count ;
+}
+
+static int stored(Map_t *map, int r, int t) // efficiency at the breakpoints r and t, as in the flash
+{
+	return (int)lround(map->eff[map->rpm_bp[r]][map->torque_bp[t]]) ;
+}
+
+static int segment(const int *values, const int *bp, int bp_count, int x, int *frac) // same as efficiency_interp()
+{
+	int i = 0 ;
+	if (x >= values[bp[bp_count-1]])
+	{
+		*frac = 256 ;
+		return bp_count-2 ;
+	}
+	if (x <= values[bp[0]])
+	{
+		*frac = 0 ;
+		return 0 ;
+	}
+	while (x >= values[bp[i+1]])
+	{
+		i++ ;
+	}
+	*frac = (int)(((unsigned long)(x-values[bp[i]]) << 8)/(unsigned)(values[bp[i+1]]-values[bp[i]])) ;
+	return i ;
+}
+
+static int interp(Map_t *map, int rpm, int torque) // same arithmetic as efficiency_interp()
+{
+	int fr, ft ;
+	int r = segment(map->rpm, map->rpm_bp, map->rpm_bp_count, rpm, &fr) ;
+	int t = segment(map->torque, map->torque_bp, map->torque_bp_count, torque, &ft) ;
+	unsigned long low = (unsigned long)stored(map, r, t)*(256-ft) + (unsigned long)stored(map, r, t+1)*ft ;
+	unsigned long high = (unsigned long)stored(map, r+1, t)*(256-ft) + (unsigned long)stored(map, r+1, t+1)*ft ;
+	return (int)((low*(256-fr) + high*fr + 32768) >> 16) ;
+}
+
+int main(int argc, char **argv)
+{
+	int count = argc-1 ;
+	double max_err[MAX_MAPS] ;
+
+	if (count < 1 || count > MAX_MAPS)
+	{
+		fprintf(stderr, "usage : efficiency_map_gen motor1.csv [motor2.csv ...] > motorefficiencies.h\n") ;
+		return 1 ;
+	}
+	for (int m = 0; m < count; m++)
+	{
+		Map_t *map = &maps[m] ;
+		if (!read_csv(argv[m+1], map))
+		{
+			return 1 ;
+		}
+		map->rpm_bp_count = choose_breakpoints(map, 1, map->rpm_bp) ;
+		map->torque_bp_count = choose_breakpoints(map, 0, map->torque_bp) ;
+		max_err[m] = 0.0 ;
+		for (int r = 0; r < map->rpm_count; r++)
+		{
+			for (int t = 0; t < map->torque_count; t++)
+			{
+				double err = fabs(interp(map, map->rpm[r], map->torque[t]) - map->eff[r][t]) ;
+				if (err > max_err[m])
+				{
+					max_err[m] = err ;
+				}
+			}
+		}
+	}
+
+	printf("/*\n * motorefficiencies.h\n *\n * Generated by tools/efficiency_map_gen.c, do not edit.\n");
+	for (int m = 0; m < count; m++)
+	{
+		Map_t *map = &maps[m] ;
+		printf(" * motor%d : %s, %d x %d points kept of %d x %d, interpolation error %.1f %% max\n", m+1, argv[m+1],
+			map->rpm_bp_count, map->torque_bp_count, map->rpm_count, map->torque_count, max_err[m]);
+	}
+	printf(" */\n\n#ifndef MOTOREFFICIENCIES_H_\n#define MOTOREFFICIENCIES_H_\n\n#include <avr/pgmspace.h>\n#include <avr/io.h>\n#include \"efficiency.h\"\n");
+	for (int m = 0; m < count; m++)
+	{
+		Map_t *map = &maps[m] ;
+		printf("\nconst uint16_t PROGMEM motor%d_rpm[%d] = {", m+1, map->rpm_bp_count);
+		for (int r = 0; r < map->rpm_bp_count; r++)
+		{
+			printf("%s%d", (r == 0) ? "" : ",", map->rpm[map->rpm_bp[r]]);
+		}
+		printf("};\nconst uint16_t PROGMEM motor%d_torque[%d] = {", m+1, map->torque_bp_count);
+		for (int t = 0; t < map->torque_bp_count; t++)
+		{
+			printf("%s%d", (t == 0) ? "" : ",", map->torque[map->torque_bp[t]]);
+		}
+		printf("}; // mNm\nconst uint8_t PROGMEM motor%d_eff[%d][%d] = { // efficiency in %%, [rpm][torque]\n", m+1, map->rpm_bp_count, map->torque_bp_count);
+		for (int r = 0; r < map->rpm_bp_count; r++)
+		{
+			printf("\t{");
+			for (int t = 0; t < map->torque_bp_count; t++)
+			{
+				printf("%s%d", (t == 0) ? "" : ",", stored(map, r, t));
+			}
+			printf("}%s\n", (r == map->rpm_bp_count-1) ? "" : ",");
+		}
+		printf("};\nconst EfficiencyMap_t motor%d = {motor%d_rpm, motor%d_torque, &motor%d_eff[0][0], %d, %d};\n",
+			m+1, m+1, m+1, m+1, map->rpm_bp_count, map->torque_bp_count);
+	}
+	printf("\n#endif /* MOTOREFFICIENCIES_H_ */\n");
+	return 0;
+}
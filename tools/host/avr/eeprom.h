@@ -0,0 +1,25 @@
+/*
+ * eeprom.h
+ *
+ * Host side stand-in of <avr/eeprom.h> for the simulations of tools/ (not part of the firmware) : the EEPROM is memory.
+ */
+
+#ifndef HOST_AVR_EEPROM_H_
+#define HOST_AVR_EEPROM_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#define EEMEM
+
+static inline void eeprom_read_block(void *dst, const void *src, size_t n)
+{
+	memcpy(dst, src, n) ;
+}
+
+static inline void eeprom_update_block(const void *src, void *dst, size_t n)
+{
+	memcpy(dst, src, n) ;
+}
+
+#endif /* HOST_AVR_EEPROM_H_ */
@@ -0,0 +1,15 @@
+/*
+ * interrupt.h
+ *
+ * Host side stand-in of <avr/interrupt.h> for the simulations of tools/ (not part of the firmware) : no interrupts.
+ */
+
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define cli()
+#define sei()
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,23 @@
+/*
+ * io.h
+ *
+ * Host side stand-in of <avr/io.h> for the simulations of tools/ (not part of the firmware) :
+ * the registers used by the simulated code are plain variables, defined by the simulation.
+ */
+
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+extern volatile uint8_t SREG, PORTB, DDRB, PORTE, DDRE, EIMSK, EIFR, EICRB ;
+extern volatile uint16_t OCR3A, OCR3B, OCR3C, ICR3 ;
+
+#define PB4 4
+#define PE5 5
+#define INT5 5
+#define INTF5 5
+#define ISC50 2
+#define ISC51 3
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,17 @@
+/*
+ * pgmspace.h
+ *
+ * Host side stand-in of <avr/pgmspace.h> for the simulations of tools/ (not part of the firmware) : flash is memory.
+ */
+
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
@@ -0,0 +1,138 @@
+/*
+ * speed_observer_sim.c
+ *
+ * Host side check (not part of the firmware) of the speed observer of speed.c, on a model of the car.
+ * Build and run on the computer : ./speed_observer_sim.sh, the exit code is 1 when the check fails.
+ *
+ * speed.c is included, so that the observer state can be reset between runs. Car model (BELT) : the motor current
+ * gives the acceleration of the observer model on a heavier car (SIM_CAR_MASS), minus rolling and air drag. The wheel
+ * magnet edges are time stamped to SIM_STEP_US, speed_update() runs every 5ms.
+ * Drive cycle : coasting, ACCEL at SIM_ACCEL_MA, coasting, BRAKE at SIM_BRAKE_MA, coasting.
+ *
+ * The same drive cycle is run twice : with the states of the state machine, and with the state IDLE all along
+ * (the motor current is then not torque for the observer, as when the prediction was gated on b_driver_status,
+ * which is never set). The speed error must be smaller with the torque term, by SIM_MIN_GAIN at least.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "../speed.c"
+
+volatile uint8_t SREG, PORTB, DDRB, PORTE, DDRE, EIMSK, EIFR, EICRB ;
+
+#define SIM_STEP_US 100
+#define SIM_TIME_S 20.0
+#define SIM_CAR_MASS 130.0 // kg, the observer model is CAR_MASS
+#define SIM_START_SPEED 5.0 // m/s
+#define SIM_ACCEL_MA 15000
+#define SIM_BRAKE_MA -10000
+#define SIM_SETTLE_S 3.0 // the errors are computed after that
+#define SIM_MIN_GAIN 0.7 // rms error with the torque term over the one without, at most
+
+static uint32_t u32_now_us = 0 ;
+
+uint32_t systime_us(void)
+{
+	return u32_now_us ;
+}
+
+uint16_t efficiency_best_current(uint16_t u16_rpm, uint16_t u16_min_mA, uint16_t u16_max_mA) // no pulse and glide here
+{
+	(void)u16_rpm ;
+	(void)u16_max_mA ;
+	return u16_min_mA ;
+}
+
+static void sim_reset(void) // observer and magnet state of speed.c, as after power up
+{
+	u32_last_edge_us = 0 ;
+	u32_period_us = 0 ;
+	b_edge_seen = 0 ;
+	b_new_period = 0 ;
+	b_new_encoder = 0 ;
+	u32_edge_count = 0 ;
+	i32_obs_speed_q8 = 0 ;
+	i32_obs_accel_corr_q8 = 0 ;
+	b_obs_running = 0 ;
+	u32_now_us = 0 ;
+}
+
+static void drive_cycle(double t, MotorControllerState_t *status, int16_t *i16_current) // s, state and mA
+{
+	if (t >= 5.0 && t < 10.0)
+	{
+		*status = ACCEL ;
+		*i16_current = SIM_ACCEL_MA ;
+	}else if (t >= 12.0 && t < 15.0)
+	{
+		*status = BRAKE ;
+		*i16_current = SIM_BRAKE_MA ;
+	}else{
+		*status = IDLE ;
+		*i16_current = 0 ;
+	}
+}
+
+static double run(uint8_t b_states, double *max_err) // rms speed error in m/s
+{
+	volatile ModuleValues_t vals = {0} ;
+	double speed = SIM_START_SPEED, pos = 0.0, next_edge = DISTANCE ;
+	double sum_sq = 0.0 ;
+	long n = 0 ;
+
+	sim_reset() ;
+	vals.pwtrain_type = BELT ;
+	*max_err = 0.0 ;
+	for (long k = 0; k*SIM_STEP_US < (long)(SIM_TIME_S*1e6); k++)
+	{
+		double t = k*SIM_STEP_US*1e-6 ;
+		MotorControllerState_t status ;
+		int16_t i16_current ;
+		drive_cycle(t, &status, &i16_current) ;
+		vals.motor_status = b_states ? status : IDLE ;
+		vals.i16_motor_current = i16_current ;
+
+		double accel = i16_current/1000.0*ACCEL_Q8_PER_A/256000.0*CAR_MASS/SIM_CAR_MASS - 0.05 - 0.002*speed*speed ;
+		speed += accel*SIM_STEP_US*1e-6 ;
+		pos += speed*SIM_STEP_US*1e-6 ;
+		u32_now_us += SIM_STEP_US ;
+		if (pos >= next_edge)
+		{
+			next_edge += DISTANCE ;
+			handle_speed_sensor() ;
+		}
+		if (k % (5000/SIM_STEP_US) == 0)
+		{
+			speed_update(&vals) ;
+			if (t >= SIM_SETTLE_S)
+			{
+				double err = fabs(i32_obs_speed_q8/256000.0 - speed) ;
+				sum_sq += err*err ;
+				n ++ ;
+				if (err > *max_err)
+				{
+					*max_err = err ;
+				}
+			}
+		}
+	}
+	return sqrt(sum_sq/n) ;
+}
+
+int main(void)
+{
+	double max_with, max_without ;
+	double rms_with = run(1, &max_with) ;
+	double rms_without = run(0, &max_without) ;
+
+	printf("speed observer, ACCEL %d mA and BRAKE %d mA, car %.0f kg (model %.0f kg)\n", SIM_ACCEL_MA, SIM_BRAKE_MA,
+		SIM_CAR_MASS, CAR_MASS) ;
+	printf("  with the torque term : rms %.3f m/s, max %.3f m/s\n", rms_with, max_with) ;
+	printf("  without : rms %.3f m/s, max %.3f m/s\n", rms_without, max_without) ;
+	if (!(rms_with <= SIM_MIN_GAIN*rms_without))
+	{
+		printf("  FAILED\n") ;
+		return 1 ;
+	}
+	return 0 ;
+}
@@ -0,0 +1,14 @@
+#!/bin/sh
+#
+# speed_observer_sim.sh
+#
+# Host side build and run of speed_observer_sim.c (not part of the firmware) : ./speed_observer_sim.sh
+
+set -e
+cd "$(dirname "$0")"
+OUT="${TMPDIR:-/tmp}/speed_observer_sim"
+CFLAGS="-std=gnu99 -O2 -Wall -Wextra -funsigned-char -fsingle-precision-constant -DF_CPU=8000000UL -Ihost"
+mkdir -p "$OUT"
+
+gcc $CFLAGS -o "$OUT/speed_observer_sim" speed_observer_sim.c ../pid.c -lm
+"$OUT/speed_observer_sim"
@@ -0,0 +1,182 @@
+/*
+ * synch_sim.c
+ *
+ * Host side check (not part of the firmware) of the speed synchronisation in ENGAGE (synch_speed_control() of speed.c)
+ * against the open loop duty cycle (compute_synch_duty() only, ENGAGE_CLOSED_LOOP_SYNCH commented out).
+ * Build and run on the computer : ./synch_sim.sh, the exit code is 1 when the check fails.
+ *
+ * speed.c is included, so that the synchronisation state can be reset between runs. Motor model (GEAR powertrain, in
+ * NEUTRAL) : the motor starts at rest, its current is the PWM voltage (OCR3 counts, as applied by controller.c) minus the
+ * back-EMF over R, the gear drag (SIM_DRAG_NM) loads it. Its motor constant differs from VOLT_SPEED_CST by SIM_EMF_SCALES.
+ * The clutch encoder speed is received every SIM_ENCODER_MS, the duty cycle is updated every 5ms.
+ *
+ * For each car speed, battery voltage and motor constant, both loops are compared on :
+ * - the engagement time : the clutch encoder speed within SYNCH_TOLERANCE_RPM of the wheel speed for SYNCH_SETTLE_TICKS
+ *   (b_speed_synch, the clutch engages the dogs), and the real speed error then, the shock on the dogs. The same
+ *   condition is computed for the open loop (-1 : never).
+ * - the settling : time from which the speed error stays within SYNCH_TOLERANCE_RPM (-1 : not at the end, the 1% duty
+ *   cycle resolution is ~130rpm) and mean error over the last SIM_SLIP_MS
+ * - the smoothness : the highest duty cycle step after the first one, and the peak motor current after the start
+ * The closed loop must engage within SIM_SYNC_MAX_MS in every case, with an error within SIM_SYNC_SLIP_MAX_RPM then
+ * (the encoder frames lag the spin up), a mean error within SYNCH_TOLERANCE_RPM and duty cycle steps of
+ * SIM_MAX_DUTY_STEP at most. It must engage no later than the open loop, when the open loop engages at all.
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "../speed.c"
+#include "../UniversalModuleDrivers/pwm.h"
+
+volatile uint8_t SREG, PORTB, DDRB, PORTE, DDRE, EIMSK, EIFR, EICRB ;
+
+#define SIM_STEP_US 100
+#define SIM_TIME_MS 1000 // in ENGAGE
+#define SIM_TICK_MS 5
+#define SIM_ENCODER_MS 10 // clutch encoder speed frame period
+#define SIM_INERTIA 1.5e-4 // kg.m2, rotor and clutch side of the gear
+#define SIM_DRAG_NM 0.03 // gear drag in NEUTRAL
+#define SIM_VISCOUS_NM_PER_KRPM 0.01
+#define SIM_START_MS 50 // the peak current is taken after the start, which is the same for both loops
+#define SIM_SLIP_MS 200
+#define SIM_SYNC_MAX_MS 500
+#define SIM_SYNC_SLIP_MAX_RPM 150
+#define SIM_MAX_DUTY_STEP 1 // %, after the first tick
+#define SIM_OCR_SCALE ((uint32_t)(PWM_TOP*65536UL/100)) // OCR3 counts per % of duty, as in controller.c
+
+static const uint16_t u16_speeds_mm_s[] = {2000, 4000, 6000} ;
+static const uint16_t u16_vbatts[] = {40000, 48000} ;
+static const double emf_scales[] = {0.95, 1.0, 1.05} ;
+#define SIM_NUM(a) (sizeof(a)/sizeof((a)[0]))
+
+typedef struct {
+	int sync_ms ; // b_speed_synch set, -1 : never
+	double sync_slip_rpm ; // speed error then
+	int settled_ms ; // within SYNCH_TOLERANCE_RPM from then to the end, -1 : not at the end
+	double slip_rpm ;
+	int duty_step ;
+	double peak_a ;
+} Engagement_t ;
+
+uint32_t systime_us(void)
+{
+	return 0 ;
+}
+
+uint16_t efficiency_best_current(uint16_t u16_rpm, uint16_t u16_min_mA, uint16_t u16_max_mA) // no pulse and glide here
+{
+	(void)u16_rpm ;
+	(void)u16_max_mA ;
+	return u16_min_mA ;
+}
+
+static double motor_volt(uint8_t u8_duty, double vbatt) // UNIPOLAR, OCR3 truncated as in controller.c
+{
+	uint16_t u16_duty_q8 = (uint16_t)u8_duty << 8 ;
+	uint16_t u16_ocr_a = (uint16_t)(((uint32_t)u16_duty_q8*SIM_OCR_SCALE) >> 24) ;
+	uint16_t u16_ocr_b = (uint16_t)(((uint32_t)((100 << 8)-u16_duty_q8)*SIM_OCR_SCALE) >> 24) ;
+	return ((double)u16_ocr_a-u16_ocr_b)/PWM_TOP*vbatt ;
+}
+
+static Engagement_t engage(uint8_t b_closed_loop, uint16_t u16_speed_mm_s, uint16_t u16_vbatt, double emf_scale)
+{
+	volatile ModuleValues_t vals = {0} ;
+	Engagement_t r = {-1, 0.0, -1, 0.0, 0, 0.0} ;
+	double rpm = 0.0, slip_sum = 0.0 ;
+	int16_t i16_target = (int16_t)(((int32_t)u16_speed_mm_s*SYNCH_RPM_PER_MM_S_Q16) >> 16) ;
+	long n_slip = 0 ;
+	uint8_t u8_open_count = 0 ;
+
+	vals.pwtrain_type = GEAR ;
+	vals.gear_status = NEUTRAL ;
+	vals.gear_required = GEAR1 ;
+	vals.motor_status = ENGAGE ;
+	vals.u16_car_speed_mm_s = u16_speed_mm_s ;
+	vals.u16_batt_volt = u16_vbatt ;
+	vals.u8_duty_cycle = compute_synch_duty(u16_speed_mm_s, GEAR1, u16_vbatt) ; // as at the start of ENGAGE
+	synch_reset() ;
+
+	for (long k = 0; k*SIM_STEP_US < SIM_TIME_MS*1000L; k++)
+	{
+		long t_us = k*SIM_STEP_US ;
+		if (t_us % (SIM_ENCODER_MS*1000L) == 0)
+		{
+			vals.u16_motor_speed = (uint16_t)(rpm+0.5) ;
+		}
+		if (t_us % (SIM_TICK_MS*1000L) == 0)
+		{
+			uint8_t u8_last = vals.u8_duty_cycle ;
+			if (b_closed_loop)
+			{
+				vals.u8_duty_cycle = synch_speed_control(&vals) ;
+			}
+			if (t_us > 0 && abs((int)vals.u8_duty_cycle-u8_last) > r.duty_step)
+			{
+				r.duty_step = abs((int)vals.u8_duty_cycle-u8_last) ;
+			}
+			// open loop : the same condition as b_speed_synch, on the clutch encoder speed
+			u8_open_count = (abs(i16_target-(int16_t)vals.u16_motor_speed) <= SYNCH_TOLERANCE_RPM) ? u8_open_count+1 : 0 ;
+			if (r.sync_ms < 0 && (b_closed_loop ? vals.b_speed_synch : u8_open_count >= SYNCH_SETTLE_TICKS))
+			{
+				r.sync_ms = (int)(t_us/1000) ;
+				r.sync_slip_rpm = fabs(i16_target-rpm) ;
+			}
+			if (fabs(i16_target-rpm) > SYNCH_TOLERANCE_RPM)
+			{
+				r.settled_ms = -1 ;
+			}else if (r.settled_ms < 0)
+			{
+				r.settled_ms = (int)(t_us/1000) ;
+			}
+			if (t_us >= (SIM_TIME_MS-SIM_SLIP_MS)*1000L)
+			{
+				slip_sum += fabs(i16_target-rpm) ;
+				n_slip ++ ;
+			}
+		}
+
+		double i = (motor_volt(vals.u8_duty_cycle, u16_vbatt/1000.0) - emf_scale*rpm/VOLT_SPEED_CST)/R ;
+		double torque = i*60.0/(2.0*PI*VOLT_SPEED_CST*emf_scale) - SIM_DRAG_NM - SIM_VISCOUS_NM_PER_KRPM*rpm/1000.0 ;
+		rpm += torque/SIM_INERTIA*60.0/(2.0*PI)*SIM_STEP_US*1e-6 ;
+		if (rpm < 0.0)
+		{
+			rpm = 0.0 ;
+		}
+		if (t_us >= SIM_START_MS*1000L && fabs(i) > r.peak_a)
+		{
+			r.peak_a = fabs(i) ;
+		}
+	}
+	r.slip_rpm = slip_sum/n_slip ;
+	return r ;
+}
+
+int main(void)
+{
+	uint8_t b_fail = 0 ;
+
+	printf("ENGAGE, closed loop (synch_speed_control) vs open loop (compute_synch_duty) : engaged ms and error then, "
+		"settled ms and mean error, duty step %%, peak A after %d ms\n", SIM_START_MS) ;
+	for (unsigned s = 0; s < SIM_NUM(u16_speeds_mm_s); s++)
+	{
+		for (unsigned v = 0; v < SIM_NUM(u16_vbatts); v++)
+		{
+			for (unsigned e = 0; e < SIM_NUM(emf_scales); e++)
+			{
+				Engagement_t cl = engage(1, u16_speeds_mm_s[s], u16_vbatts[v], emf_scales[e]) ;
+				Engagement_t ol = engage(0, u16_speeds_mm_s[s], u16_vbatts[v], emf_scales[e]) ;
+				uint8_t b_ok = cl.sync_ms >= 0 && cl.sync_ms <= SIM_SYNC_MAX_MS && cl.sync_slip_rpm <= SIM_SYNC_SLIP_MAX_RPM
+					&& cl.slip_rpm <= SYNCH_TOLERANCE_RPM && cl.duty_step <= SIM_MAX_DUTY_STEP
+					&& (ol.sync_ms < 0 || cl.sync_ms <= ol.sync_ms) ;
+				printf("  %.1f m/s %.0f V motor constant x%.2f : closed %3d ms %3.0f rpm, %3d ms %3.0f rpm %d %% %4.1f A, "
+					"open %3d ms %3.0f rpm, %3d ms %3.0f rpm %d %% %4.1f A%s\n", u16_speeds_mm_s[s]/1000.0, u16_vbatts[v]/1000.0,
+					emf_scales[e], cl.sync_ms, cl.sync_slip_rpm, cl.settled_ms, cl.slip_rpm, cl.duty_step, cl.peak_a,
+					ol.sync_ms, ol.sync_slip_rpm, ol.settled_ms, ol.slip_rpm, ol.duty_step, ol.peak_a, b_ok ? "" : "  FAILED") ;
+				if (!b_ok)
+				{
+					b_fail = 1 ;
+				}
+			}
+		}
+	}
+	return b_fail ;
+}
@@ -0,0 +1,14 @@
+#!/bin/sh
+#
+# synch_sim.sh
+#
+# Host side build and run of synch_sim.c (not part of the firmware) : ./synch_sim.sh
+
+set -e
+cd "$(dirname "$0")"
+OUT="${TMPDIR:-/tmp}/synch_sim"
+CFLAGS="-std=gnu99 -O2 -Wall -Wextra -funsigned-char -fsingle-precision-constant -DF_CPU=8000000UL -Ihost"
+mkdir -p "$OUT"
+
+gcc $CFLAGS -o "$OUT/synch_sim" synch_sim.c ../pid.c -lm
+"$OUT/synch_sim"
@@ -0,0 +1,96 @@
+/*
+ * thermistor_table_gen.c
+ *
+ * Host side generator (not part of the firmware) of thermistor_table.h, used by handle_temp_sensor() in sensors.c
+ * Build and run on the computer : gcc -o thermistor_table_gen thermistor_table_gen.c -lm && ./thermistor_table_gen > ../thermistor_table.h
+ *
+ * Thermistor NTC 495-75654-ND (EPCOS B57861S103F40) : R25 = 10k, B25/100 = 3988K
+ * Divider on Motor Drive V2.0 : NTC to 5V, 10k to ground, read by the MCP3208 (12bit, Vref = 5V)
+ * Define USE_STEINHART_HART and the coefficients to use the Steinhart-Hart model instead of Beta.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#define R_FIXED 10000.0
+#define R_25 10000.0
+#define BETA 3988.0
+// USE_STEINHART_HART
+#define SH_A 1.125e-3
+#define SH_B 2.347e-4
+#define SH_C 8.566e-8
+
+#define ADC_BITS 12
+#define INDEX_BITS 6 // table indexed by the top bits of the ADC code (7 : 1.1 degC max error up to 150 degC)
+#define FRAC_BITS (ADC_BITS-INDEX_BITS)
+#define TABLE_SIZE ((1 << INDEX_BITS)+1)
+#define Q_BITS 4 // temperatures in 1/16 degC
+#define T_MIN -40.0
+#define T_MAX 255.0
+#define CHECK_T_MAX 120.0 // interpolation error checked from 0 degC to CHECK_T_MAX (MAX_TEMP is 100 in state_machine.c)
+
+static double ntc_temperature(double code) // in degC, from the ADC code
+{
+	double v = code*5.0/(1 << ADC_BITS);
+	if (v <= 0.0)
+	{
+		return T_MIN;
+	}
+	if (v >= 5.0)
+	{
+		return T_MAX;
+	}
+	double r_ntc = R_FIXED*(5.0/v-1.0);
+#ifdef USE_STEINHART_HART
+	double ln_r = log(r_ntc);
+	double t = 1.0/(SH_A+SH_B*ln_r+SH_C*ln_r*ln_r*ln_r)-273.15;
+#else
+	double t = 1.0/(1.0/298.15+log(r_ntc/R_25)/BETA)-273.15;
+#endif
+	if (t < T_MIN) t = T_MIN;
+	if (t > T_MAX) t = T_MAX;
+	return t;
+}
+
+int main(void)
+{
+	int table[TABLE_SIZE];
+	double max_err = 0.0;
+
+	for (int i = 0; i < TABLE_SIZE; i++)
+	{
+		table[i] = (int)lround(ntc_temperature(i << FRAC_BITS)*(1 << Q_BITS));
+	}
+
+	// same interpolation as handle_temp_sensor(), checked against the model over the useful range
+	for (int code = 0; code < (1 << ADC_BITS); code++)
+	{
+		int i = code >> FRAC_BITS;
+		int frac = code & ((1 << FRAC_BITS)-1);
+		int t_q = table[i]+(((table[i+1]-table[i])*frac) >> FRAC_BITS);
+		double t = (double)t_q/(1 << Q_BITS);
+		double t_model = ntc_temperature(code);
+		if (t_model >= 0.0 && t_model <= CHECK_T_MAX && fabs(t-t_model) > max_err)
+		{
+			max_err = fabs(t-t_model);
+		}
+	}
+
+	printf("/*\n * thermistor_table.h\n *\n * Generated by tools/thermistor_table_gen.c, do not edit.\n");
+#ifdef USE_STEINHART_HART
+	printf(" * Steinhart-Hart model A = %g, B = %g, C = %g, R fixed = %.0f\n", SH_A, SH_B, SH_C, R_FIXED);
+#else
+	printf(" * Beta model R25 = %.0f, B = %.0f, R fixed = %.0f\n", R_25, BETA, R_FIXED);
+#endif
+	printf(" * Interpolation error from 0 to %.0f degC : %.2f degC max\n */\n\n", CHECK_T_MAX, max_err);
+	printf("#ifndef THERMISTOR_TABLE_H_\n#define THERMISTOR_TABLE_H_\n\n#include <avr/pgmspace.h>\n\n");
+	printf("#define THERMISTOR_INDEX_SHIFT %d // index = ADC code >> THERMISTOR_INDEX_SHIFT\n", FRAC_BITS);
+	printf("#define THERMISTOR_Q_SHIFT %d // temperatures in 1/%d degC\n\n", Q_BITS, 1 << Q_BITS);
+	printf("const int16_t PROGMEM thermistor_table[%d] = {", TABLE_SIZE);
+	for (int i = 0; i < TABLE_SIZE; i++)
+	{
+		printf("%s%s%d", (i == 0) ? "" : ",", (i%16 == 0) ? "\n\t" : "", table[i]);
+	}
+	printf("\n};\n\n#endif /* THERMISTOR_TABLE_H_ */\n");
+	return 0;
+}
@@ -0,0 +1,325 @@
+/*
+ * torque_split_table_gen.c
+ *
+ * Host side generator (not part of the firmware) of torque_split_table.h, used by efficient_gain() in efficiency.c
+ * Build and run on the computer : gcc -o torque_split_table_gen torque_split_table_gen.c && ./torque_split_table_gen ../motorefficiencies.h > ../torque_split_table.h
+ *
+ * The efficiency maps are read from motorefficiencies.h (text), so the table follows any change of the maps, and
+ * interpolated every MOTOR_RPM_STEP of motor speed and STEP_TO_TORQUE as by efficiency_interp().
+ * The reductions and torque constants are the ones of powertrain.h, the other constants below are the ones of
+ * efficiency.c and have to be kept the same. The wheel torque is counted in STEP_TO_TORQUE/WHEEL_TO_MOTOR_DEN steps,
+ * so that a column of each motor is a whole number of steps with the ratios in 1/WHEEL_TO_MOTOR_DEN.
+ *
+ * Table : the wheel speed is cut in segments where the rows of both maps stay the same, split_segment[] gives the
+ * segment of each wheel rpm. For each segment and each driver command (A, on both controllers), the torque of each
+ * motor in map columns, the split of the lowest electrical power. At run time : two indexed flash reads.
+ * Every wheel rpm up to CHECK_RPM_MAX and every command are checked against the brute force search.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "../powertrain.h"
+
+#define MOTOR_RPM_STEP 50
+#define STEP_TO_TORQUE 20 // mNm per column
+#define KT_WHEEL ((unsigned)(KT_MOTOR1*WHEEL_TO_MOTOR1_RPM + KT_MOTOR2*WHEEL_TO_MOTOR2_RPM)) // wheel torque of both motors, mNm/A
+#define WHEEL_STEP (STEP_TO_TORQUE/WHEEL_TO_MOTOR_DEN) // mNm of wheel torque per step
+#define RATIO1 ((int)(WHEEL_TO_MOTOR1_RPM*WHEEL_TO_MOTOR_DEN+0.5)) // wheel steps per column of motor1
+#define RATIO2 ((int)(WHEEL_TO_MOTOR2_RPM*WHEEL_TO_MOTOR_DEN+0.5))
+
+#define NO_SPLIT 0xFF
+#define CMD_MAX 255 // u8_accel_cmd
+#define CHECK_RPM_MAX 1000
+#define MAX_ROWS 256 // of the maps sampled every MOTOR_RPM_STEP and STEP_TO_TORQUE
+#define MAX_COLS 256
+
+static unsigned char map1[MAX_ROWS][MAX_COLS], map2[MAX_ROWS][MAX_COLS] ;
+static int rows1, cols1, rows2, cols2 ;
+static int steps_max ; // wheel steps of both motors at their last column
+
+static void skip_comments(const char **p)
+{
+	for (;;)
+	{
+		while (isspace((unsigned char)**p))
+		{
+			(*p)++ ;
+		}
+		if (strncmp(*p, "//", 2) == 0)
+		{
+			*p = strchr(*p, '\n') ? strchr(*p, '\n') : *p+strlen(*p) ;
+		}else if (strncmp(*p, "/*", 2) == 0)
+		{
+			*p = strstr(*p, "*/") ? strstr(*p, "*/")+2 : *p+strlen(*p) ;
+		}else{
+			return ;
+		}
+	}
+}
+
+static int read_array(const char *text, const char *name, int *values, int max) // number of values, 0 if not found
+{
+	char key[32] ;
+	int rows = 1 ;
+	int cols = 1 ;
+	snprintf(key, sizeof(key), "%s[", name) ;
+	const char *p = strstr(text, key) ;
+	if (p == NULL || sscanf(p+strlen(key), "%d][%d]", &rows, &cols) < 1 || rows*cols > max)
+	{
+		return 0 ;
+	}
+	p = strchr(p, '=') ;
+	for (int n = 0; p != NULL && n < rows*cols; )
+	{
+		skip_comments(&p) ;
+		if (*p == '\0' || *p == ';')
+		{
+			return 0 ; // fewer values than the dimensions
+		}
+		if (isdigit((unsigned char)*p))
+		{
+			values[n++] = (int)strtol(p, (char **)&p, 10) ;
+		}else{
+			p++ ;
+		}
+	}
+	return (p != NULL) ? rows*cols : 0 ;
+}
+
+static int bracket(const int *points, int count, int x, int *frac) // same as efficiency_interp()
+{
+	int i = 0 ;
+	if (x <= points[0])
+	{
+		*frac = 0 ;
+		return 0 ;
+	}
+	while (x >= points[i+1])
+	{
+		if (i+2 >= count)
+		{
+			*frac = 256 ;
+			return i ;
+		}
+		i++ ;
+	}
+	*frac = (int)(((unsigned long)(x-points[i]) << 8)/(unsigned)(points[i+1]-points[i])) ;
+	return i ;
+}
+
+// compressed map of motorefficiencies.h, interpolated as by efficiency_interp() every MOTOR_RPM_STEP and STEP_TO_TORQUE
+static int read_map(const char *text, const char *name, unsigned char map[MAX_ROWS][MAX_COLS], int *rows, int *cols) // 0 if not found
+{
+	static int rpm[MAX_COLS], torque[MAX_COLS], eff[MAX_COLS*MAX_COLS] ;
+	char key[32] ;
+	snprintf(key, sizeof(key), "%s_rpm", name) ;
+	int rpm_count = read_array(text, key, rpm, MAX_COLS) ;
+	snprintf(key, sizeof(key), "%s_torque", name) ;
+	int torque_count = read_array(text, key, torque, MAX_COLS) ;
+	snprintf(key, sizeof(key), "%s_eff", name) ;
+	if (rpm_count < 2 || torque_count < 2 || read_array(text, key, eff, MAX_COLS*MAX_COLS) != rpm_count*torque_count)
+	{
+		return 0 ;
+	}
+	*rows = rpm[rpm_count-1]/MOTOR_RPM_STEP+1 ;
+	*cols = torque[torque_count-1]/STEP_TO_TORQUE+1 ;
+	if (*rows > MAX_ROWS || *cols > MAX_COLS)
+	{
+		return 0 ;
+	}
+	for (int r = 0; r < *rows; r++)
+	{
+		for (int c = 0; c < *cols; c++)
+		{
+			int fr, ft ;
+			int i = bracket(rpm, rpm_count, r*MOTOR_RPM_STEP, &fr) ;
+			int j = bracket(torque, torque_count, c*STEP_TO_TORQUE, &ft) ;
+			const int *low = &eff[i*torque_count+j] ;
+			const int *high = low+torque_count ;
+			unsigned long u_low = (unsigned long)low[0]*(256-ft) + (unsigned long)low[1]*ft ;
+			unsigned long u_high = (unsigned long)high[0]*(256-ft) + (unsigned long)high[1]*ft ;
+			map[r][c] = (unsigned char)((u_low*(256-fr) + u_high*fr + 32768) >> 16) ;
+		}
+	}
+	return 1 ;
+}
+
+static int row1(int wheel_rpm)
+{
+	int r = wheel_rpm*RATIO1/(MOTOR_RPM_STEP*WHEEL_TO_MOTOR_DEN) ;
+	return (r < rows1) ? r : rows1-1 ;
+}
+
+static int row2(int wheel_rpm)
+{
+	int r = wheel_rpm*RATIO2/(MOTOR_RPM_STEP*WHEEL_TO_MOTOR_DEN) ;
+	return (r < rows2) ? r : rows2-1 ;
+}
+
+static int wheel_steps(int cmd) // same rounding and bound as efficient_gain()
+{
+	unsigned torque = (unsigned)cmd*KT_WHEEL ;
+	int steps = (int)(((torque > 0xFFFE) ? 0xFFFE : torque) + WHEEL_STEP/2)/WHEEL_STEP ;
+	return (steps > steps_max) ? steps_max : steps ;
+}
+
+// brute force over the columns of both motors : motor1 at each column, motor2 at the rest rounded up, lowest power
+static void brute_force(int r1, int r2, int steps, int *best1, int *best2)
+{
+	double best = 1e18 ;
+	*best1 = NO_SPLIT ;
+	*best2 = NO_SPLIT ;
+	for (int c1 = 0; c1 < cols1; c1++)
+	{
+		int s1 = c1*RATIO1 ;
+		int s2 = (s1 < steps) ? steps-s1 : 0 ;
+		int c2 = (s2 + RATIO2-1)/RATIO2 ;
+		if (s1 >= steps + RATIO1)
+		{
+			break ;
+		}
+		if (c2 >= cols2)
+		{
+			continue ;
+		}
+		int e1 = (c1 == 0) ? 100 : map1[r1][c1] ;
+		int e2 = (s2 == 0) ? 100 : map2[r2][c2] ;
+		if (e1 == 0 || e2 == 0)
+		{
+			continue ;
+		}
+		double cost = s1/(double)e1 + s2/(double)e2 ;
+		if (cost < best-1e-12)
+		{
+			best = cost ;
+			*best1 = c1 ;
+			*best2 = c2 ;
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	static char text[1 << 20] ;
+	static int segment[CHECK_RPM_MAX+1] ;
+	static unsigned char table1[256][CMD_MAX+1], table2[256][CMD_MAX+1] ;
+	int seg_r1[256], seg_r2[256] ;
+	int segments = 0 ;
+	int rpm_rows = 0 ;
+	int cmd_cols = 0 ;
+	long cases = 0 ;
+	long mismatches = 0 ;
+
+	if (STEP_TO_TORQUE % WHEEL_TO_MOTOR_DEN != 0 || RATIO1 != WHEEL_TO_MOTOR1_RPM*WHEEL_TO_MOTOR_DEN || RATIO2 != WHEEL_TO_MOTOR2_RPM*WHEEL_TO_MOTOR_DEN)
+	{
+		fprintf(stderr, "the ratios of powertrain.h and STEP_TO_TORQUE have to be multiples of 1/WHEEL_TO_MOTOR_DEN\n") ;
+		return 1 ;
+	}
+	FILE *f = fopen((argc > 1) ? argv[1] : "../motorefficiencies.h", "r") ;
+	if (f == NULL)
+	{
+		fprintf(stderr, "cannot open the efficiency maps\n") ;
+		return 1 ;
+	}
+	text[fread(text, 1, sizeof(text)-1, f)] = '\0' ;
+	fclose(f) ;
+	if (!read_map(text, "motor1", map1, &rows1, &cols1) || !read_map(text, "motor2", map2, &rows2, &cols2))
+	{
+		fprintf(stderr, "motor1 or motor2 not found, or fewer values than the dimensions\n") ;
+		return 1 ;
+	}
+	steps_max = (cols1-1)*RATIO1 + (cols2-1)*RATIO2 ;
+
+	// segments of wheel speed, up to the speed where both rows are the last ones
+	for (int rpm = 0; rpm <= CHECK_RPM_MAX; rpm++)
+	{
+		if (segments == 0 || row1(rpm) != seg_r1[segments-1] || row2(rpm) != seg_r2[segments-1])
+		{
+			if (segments == 256)
+			{
+				fprintf(stderr, "more than 256 wheel speed segments\n") ;
+				return 1 ;
+			}
+			seg_r1[segments] = row1(rpm) ;
+			seg_r2[segments] = row2(rpm) ;
+			segments++ ;
+			rpm_rows = rpm+1 ;
+		}
+		segment[rpm] = segments-1 ;
+	}
+	// commands, up to the one where the torque reaches both motors at their last column
+	while (cmd_cols <= CMD_MAX && (cmd_cols == 0 || wheel_steps(cmd_cols-1) < steps_max))
+	{
+		cmd_cols++ ;
+	}
+
+	for (int s = 0; s < segments; s++)
+	{
+		for (int cmd = 0; cmd < cmd_cols; cmd++)
+		{
+			int c1, c2 ;
+			brute_force(seg_r1[s], seg_r2[s], wheel_steps(cmd), &c1, &c2) ;
+			table1[s][cmd] = (unsigned char)c1 ;
+			table2[s][cmd] = (unsigned char)c2 ;
+		}
+	}
+
+	// same lookup as efficient_gain(), against the brute force at the exact speed and command
+	for (int rpm = 0; rpm <= CHECK_RPM_MAX; rpm++)
+	{
+		for (int cmd = 0; cmd <= CMD_MAX; cmd++)
+		{
+			int s = segment[(rpm < rpm_rows) ? rpm : rpm_rows-1] ;
+			int col = (cmd < cmd_cols) ? cmd : cmd_cols-1 ;
+			int c1, c2 ;
+			brute_force(row1(rpm), row2(rpm), wheel_steps(cmd), &c1, &c2) ;
+			cases++ ;
+			if (table1[s][col] != c1 || table2[s][col] != c2)
+			{
+				if (mismatches++ < 10)
+				{
+					fprintf(stderr, "wheel %d rpm, %d A : table %d/%d, brute force %d/%d\n", rpm, cmd, table1[s][col], table2[s][col], c1, c2) ;
+				}
+			}
+		}
+	}
+	if (mismatches != 0)
+	{
+		fprintf(stderr, "%ld mismatches over %ld cases, no table written\n", mismatches, cases) ;
+		return 1 ;
+	}
+
+	printf("/*\n * torque_split_table.h\n *\n * Generated by tools/torque_split_table_gen.c, do not edit.\n");
+	printf(" * Maps motor1 %d x %d, motor2 %d x %d (every %d rpm and %d mNm), wheel torque %u mNm per A of command\n", rows1, cols1, rows2, cols2, MOTOR_RPM_STEP, STEP_TO_TORQUE, KT_WHEEL);
+	printf(" * Checked against the brute force search : %ld cases (wheel 0 to %d rpm, 0 to %d A), no mismatch\n */\n\n", cases, CHECK_RPM_MAX, CMD_MAX);
+	printf("#ifndef TORQUE_SPLIT_TABLE_H_\n#define TORQUE_SPLIT_TABLE_H_\n\n#include <avr/pgmspace.h>\n\n");
+	printf("#define SPLIT_RPM_ROWS %d // wheel rpm above : last segment\n", rpm_rows);
+	printf("#define SPLIT_CMD_COLS %d // commands above : last column (both motors at their last column)\n", cmd_cols);
+	printf("#define SPLIT_TORQUE_STEP %u // mNm of wheel torque per column, one A of command on both controllers\n", KT_WHEEL);
+	printf("#define SPLIT_NONE %d // no split is a working point of the maps (standstill)\n\n", NO_SPLIT);
+	printf("// segment of each wheel rpm\nconst uint8_t PROGMEM split_segment[SPLIT_RPM_ROWS] = {");
+	for (int rpm = 0; rpm < rpm_rows; rpm++)
+	{
+		printf("%s%s%d", (rpm == 0) ? "" : ",", (rpm%32 == 0) ? "\n\t" : "", segment[rpm]);
+	}
+	printf("\n};\n");
+	for (int m = 1; m <= 2; m++) // static : only the table of the motor of the controller is linked
+	{
+		printf("\n// torque of motor%d in map columns, [segment][command in A]\n", m);
+		printf("static const uint8_t PROGMEM split_motor%d[%d][SPLIT_CMD_COLS] = {\n", m, segments);
+		for (int s = 0; s < segments; s++)
+		{
+			printf("\t{");
+			for (int cmd = 0; cmd < cmd_cols; cmd++)
+			{
+				printf("%s%d", (cmd == 0) ? "" : ",", (m == 1) ? table1[s][cmd] : table2[s][cmd]);
+			}
+			printf("}%s\n", (s == segments-1) ? "" : ",");
+		}
+		printf("};\n");
+	}
+	printf("\n#endif /* TORQUE_SPLIT_TABLE_H_ */\n");
+	return 0;
+}
@@ -0,0 +1,238 @@
+/*
+ * torque_split_table.h
+ *
+ * Generated by tools/torque_split_table_gen.c, do not edit.
+ * Maps motor1 99 x 61, motor2 75 x 101 (every 50 rpm and 20 mNm), wheel torque 3434 mNm per A of command
+ * Checked against the brute force search : 256256 cases (wheel 0 to 1000 rpm, 0 to 255 A), no mismatch
+ */
+
+#ifndef TORQUE_SPLIT_TABLE_H_
+#define TORQUE_SPLIT_TABLE_H_
+
+#include <avr/pgmspace.h>
+
+#define SPLIT_RPM_ROWS 263 // wheel rpm above : last segment
+#define SPLIT_CMD_COLS 19 // commands above : last column (both motors at their last column)
+#define SPLIT_TORQUE_STEP 3434 // mNm of wheel torque per column, one A of command on both controllers
+#define SPLIT_NONE 255 // no split is a working point of the maps (standstill)
+
+// segment of each wheel rpm
+const uint8_t PROGMEM split_segment[SPLIT_RPM_ROWS] = {
+	0,0,0,1,1,1,2,2,3,3,3,4,4,4,5,5,6,6,6,7,7,7,8,8,9,9,9,10,10,10,11,11,
+	12,12,12,13,13,13,14,14,15,15,15,16,16,16,17,17,18,18,18,19,19,19,20,20,21,21,21,22,22,22,23,23,
+	24,24,24,25,25,25,26,26,27,27,27,28,28,28,29,29,30,30,30,31,31,31,32,32,33,33,33,34,34,34,35,35,
+	36,36,36,37,37,37,38,38,39,39,39,40,40,40,41,41,42,42,42,43,43,43,44,44,45,45,45,46,46,46,47,47,
+	48,48,48,49,49,49,50,50,51,51,51,52,52,52,53,53,54,54,54,55,55,55,56,56,57,57,57,58,58,58,59,59,
+	60,60,60,61,61,61,62,62,63,63,63,64,64,64,65,65,66,66,66,67,67,67,68,68,69,69,69,70,70,70,71,71,
+	72,72,72,73,73,73,74,74,75,75,75,76,76,76,77,77,78,78,78,79,79,79,80,80,81,81,81,82,82,82,83,83,
+	84,84,84,85,85,85,86,86,87,87,87,88,88,88,89,89,90,90,90,91,91,91,92,92,93,93,93,94,94,94,95,95,
+	96,96,96,97,97,97,98
+};
+
+// torque of motor1 in map columns, [segment][command in A]
+static const uint8_t PROGMEM split_motor1[99][SPLIT_CMD_COLS] = {
+	{0,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+	{0,3,4,7,12,13,17,22,21,24,27,29,30,32,41,42,51,60,60},
+	{0,3,4,8,11,11,14,18,20,23,26,24,27,31,33,38,47,56,60},
+	{0,2,5,8,12,13,13,18,17,23,26,27,32,34,34,38,47,56,60},
+	{0,3,5,8,12,13,14,18,18,24,26,27,28,34,35,40,49,56,60},
+	{0,3,6,6,12,13,14,18,18,24,28,28,30,37,33,42,47,56,60},
+	{0,3,6,8,9,12,13,19,18,24,28,28,30,30,35,38,47,56,60},
+	{0,4,5,8,12,11,13,19,18,24,28,28,30,30,39,40,49,56,60},
+	{0,4,5,9,12,11,17,18,22,23,27,29,28,31,33,42,51,56,60},
+	{0,3,6,8,11,12,14,17,21,27,28,27,29,36,34,39,48,57,60},
+	{0,4,5,9,11,11,13,19,20,26,26,28,30,37,39,40,49,56,60},
+	{0,3,6,7,11,15,17,20,21,24,24,29,34,37,39,40,49,56,60},
+	{0,4,5,7,11,12,14,19,20,25,24,26,31,34,39,40,49,56,60},
+	{0,4,6,7,11,14,18,18,21,23,26,27,28,34,35,40,49,56,60},
+	{0,3,7,8,10,11,17,19,19,24,22,28,28,30,35,40,49,56,60},
+	{0,4,7,7,12,12,15,17,19,24,29,27,29,38,35,44,48,57,60},
+	{0,5,5,9,10,13,16,17,19,24,25,26,35,37,34,39,47,56,60},
+	{0,4,7,7,11,15,17,17,18,23,24,29,34,36,41,41,47,56,60},
+	{0,4,6,9,10,12,18,17,18,23,24,29,34,36,31,40,49,58,60},
+	{0,4,5,7,12,13,18,18,18,23,27,28,33,35,35,38,47,56,60},
+	{0,4,7,10,10,15,15,17,22,22,27,27,28,38,33,42,47,56,60},
+	{0,4,6,9,11,13,18,17,20,19,28,29,29,31,40,38,47,56,60},
+	{0,4,8,8,10,15,16,19,17,21,25,26,31,36,36,38,47,56,60},
+	{0,5,6,9,13,13,17,20,20,23,27,27,32,37,29,38,47,56,60},
+	{0,5,5,11,11,15,16,18,22,25,24,29,29,38,38,40,49,58,60},
+	{0,9,6,9,9,13,18,20,19,22,25,30,34,35,32,41,50,56,60},
+	{0,9,7,9,12,15,15,17,21,25,27,26,30,36,34,42,51,56,60},
+	{0,9,7,10,11,14,18,20,19,22,25,29,33,33,37,39,47,56,60},
+	{0,9,8,10,10,13,18,18,23,25,28,32,36,36,34,42,47,56,60},
+	{0,9,9,9,9,12,17,17,20,22,25,29,33,33,37,39,47,56,60},
+	{0,9,9,9,9,11,14,19,23,26,23,32,36,35,39,41,50,56,60},
+	{0,9,10,10,15,15,18,17,20,24,27,24,33,38,36,38,47,56,60},
+	{0,9,10,10,14,14,17,21,19,21,25,28,36,35,38,40,49,58,60},
+	{0,9,9,9,12,12,16,18,22,24,27,24,33,38,34,43,47,56,60},
+	{0,9,9,9,11,11,13,15,19,21,25,33,36,35,30,40,48,57,60},
+	{0,9,10,10,10,18,18,20,22,24,28,30,33,37,34,42,47,60,60},
+	{0,9,10,10,10,16,16,18,20,24,26,30,33,36,39,40,49,58,60},
+	{0,9,10,10,10,14,16,18,21,23,25,27,36,34,36,39,47,56,60},
+	{0,9,10,10,14,12,15,15,19,27,29,32,34,32,35,42,51,56,60},
+	{0,9,10,9,13,13,20,22,24,26,28,30,33,36,39,41,49,58,60},
+	{0,9,10,11,11,11,20,22,22,25,27,29,31,34,37,45,47,56,60},
+	{0,9,6,9,9,18,18,21,21,23,25,28,30,32,35,42,51,60,60},
+	{0,9,6,9,9,16,16,19,21,21,24,32,34,31,39,42,49,58,60},
+	{0,9,6,12,12,14,17,17,20,27,29,32,32,37,37,45,47,56,60},
+	{0,9,6,12,14,12,15,23,25,25,28,28,30,33,41,42,47,56,60},
+	{0,9,10,13,13,13,21,24,24,24,26,34,35,37,40,40,49,58,60},
+	{0,9,10,8,13,13,19,22,22,22,24,32,35,35,44,38,47,56,60},
+	{0,9,9,10,10,19,19,19,22,22,30,30,30,33,41,42,47,56,60},
+	{0,9,9,10,11,17,17,20,20,28,28,28,30,39,40,42,50,59,60},
+	{0,9,9,11,11,17,17,26,20,28,28,28,36,31,40,40,48,57,60},
+	{0,9,9,11,15,18,15,18,26,26,26,34,35,38,38,38,47,56,60},
+	{0,9,9,12,12,15,15,24,24,24,24,24,35,35,35,44,47,56,60},
+	{0,9,9,12,16,16,16,25,25,25,25,33,33,33,42,43,47,56,60},
+	{0,9,9,13,13,16,13,25,22,22,31,31,31,31,40,43,50,59,60},
+	{0,9,5,13,13,13,23,23,23,23,32,29,29,29,38,47,48,57,60},
+	{0,9,6,14,14,14,23,20,20,29,29,29,29,38,38,38,47,56,60},
+	{0,9,10,15,14,15,21,21,18,27,27,27,36,36,36,44,47,56,60},
+	{0,9,10,15,15,15,21,18,27,27,27,27,34,34,34,43,52,56,60},
+	{0,9,10,15,16,22,19,16,25,25,25,34,34,34,34,43,50,59,60},
+	{0,9,10,15,16,22,19,16,26,26,26,32,32,32,41,48,48,57,60},
+	{0,9,10,15,16,19,16,26,23,23,33,33,29,39,39,39,47,56,60},
+	{0,9,10,13,13,20,17,26,23,30,30,30,30,39,36,44,53,56,60},
+	{0,9,9,10,13,20,17,23,20,31,31,27,37,34,34,43,47,60,60},
+	{0,9,9,14,14,17,14,24,20,31,31,27,38,34,34,41,50,59,60},
+	{0,9,9,14,14,17,14,24,20,28,28,28,35,32,42,42,49,58,60},
+	{0,9,9,15,15,18,25,21,29,29,36,36,36,32,43,39,47,56,60},
+	{0,9,9,15,15,15,25,18,29,29,35,36,33,33,40,40,47,56,60},
+	{0,9,9,10,15,15,25,18,30,25,25,37,33,41,41,47,48,56,60},
+	{0,9,9,10,15,15,22,15,26,33,34,34,31,42,38,38,48,56,60},
+	{0,9,9,16,16,16,22,16,27,33,35,35,31,39,39,46,49,56,60},
+	{0,9,9,16,16,16,19,16,27,32,32,32,40,40,36,43,52,56,60},
+	{0,9,9,16,16,16,19,28,23,33,33,40,41,37,33,41,48,56,60},
+	{0,9,9,16,16,16,16,29,24,33,33,29,41,37,45,41,48,56,60},
+	{0,9,9,16,16,16,16,29,24,33,33,29,37,37,45,41,48,56,60},
+	{0,9,9,16,17,17,17,25,20,30,38,38,38,34,45,38,49,56,60},
+	{0,9,9,16,17,17,17,25,20,30,38,38,38,34,46,38,49,56,60},
+	{0,9,9,16,17,17,17,26,21,31,38,39,39,35,43,39,50,56,60},
+	{0,9,9,14,14,14,14,26,21,31,38,39,39,35,43,39,47,56,60},
+	{0,9,9,14,18,18,18,27,32,32,32,40,36,36,44,40,47,56,60},
+	{0,9,9,14,18,18,18,27,32,32,32,40,36,36,44,40,48,56,60},
+	{0,9,9,15,19,19,19,23,33,33,33,41,37,37,44,41,48,56,60},
+	{0,9,9,15,19,19,19,24,33,29,29,41,37,37,45,41,49,56,60},
+	{0,9,9,15,19,19,19,24,33,29,29,41,37,37,45,41,49,56,60},
+	{0,9,9,15,19,20,20,25,34,30,38,38,38,46,46,38,50,56,60},
+	{0,9,9,16,16,20,20,25,34,30,38,38,38,46,46,38,50,56,60},
+	{0,9,9,16,16,21,21,26,35,31,39,39,39,35,43,39,47,56,60},
+	{0,9,9,16,16,21,21,26,35,31,39,39,39,35,43,39,47,56,60},
+	{0,9,9,16,17,22,22,27,32,32,40,40,36,36,44,40,48,56,60},
+	{0,9,9,16,17,22,22,27,32,32,40,40,36,36,44,40,48,57,60},
+	{0,9,9,18,18,23,23,23,33,33,41,41,37,37,45,41,49,57,60},
+	{0,9,9,18,18,23,23,23,33,33,41,41,37,37,45,41,50,58,60},
+	{0,9,9,18,18,23,23,23,33,33,41,41,37,46,46,41,50,59,60},
+	{0,9,9,18,18,23,23,23,33,33,42,42,37,46,46,42,51,56,60},
+	{0,9,9,18,18,23,23,23,33,33,38,38,47,47,47,52,47,57,60},
+	{0,9,9,18,18,23,23,23,33,33,38,38,48,48,43,53,48,58,60},
+	{0,9,9,18,18,23,23,23,33,33,38,38,48,48,43,54,48,59,60},
+	{0,9,9,18,18,23,23,23,33,33,39,39,49,49,55,55,49,60,60},
+	{0,9,9,18,18,23,23,23,33,33,39,39,56,50,56,56,50,56,60},
+	{0,9,9,18,18,23,23,23,34,34,40,40,56,57,57,57,51,57,60}
+};
+
+// torque of motor2 in map columns, [segment][command in A]
+static const uint8_t PROGMEM split_motor2[99][SPLIT_CMD_COLS] = {
+	{0,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+	{0,7,15,21,25,33,38,43,53,59,65,72,80,88,88,96,96,96,100},
+	{0,7,15,20,26,35,41,47,54,60,66,77,83,89,96,100,100,100,100},
+	{0,8,14,20,25,33,42,47,57,60,66,74,78,86,95,100,100,100,100},
+	{0,7,14,20,25,33,41,47,56,59,66,74,82,86,94,98,98,100,100},
+	{0,7,13,22,25,33,41,47,56,59,64,73,80,83,96,96,100,100,100},
+	{0,7,13,20,28,34,42,46,56,59,64,73,80,90,94,100,100,100,100},
+	{0,6,14,20,25,35,42,46,56,59,64,73,80,90,90,98,98,100,100},
+	{0,6,14,19,25,35,38,47,52,60,65,72,82,89,96,96,96,100,100},
+	{0,7,13,20,26,34,41,48,53,56,64,74,81,84,95,99,99,99,100},
+	{0,6,14,19,26,35,42,46,54,57,66,73,80,83,90,98,98,100,100},
+	{0,7,13,21,26,31,38,45,53,59,68,72,76,83,90,98,98,100,100},
+	{0,6,14,21,26,34,41,46,54,58,68,75,79,86,90,98,98,100,100},
+	{0,6,13,21,26,32,37,47,53,60,66,74,82,86,94,98,98,100,100},
+	{0,7,12,20,27,35,38,46,55,59,70,73,82,90,94,98,98,100,100},
+	{0,6,12,21,25,34,40,48,55,59,63,74,81,82,94,94,99,99,100},
+	{0,5,14,19,27,33,39,48,55,59,67,75,75,83,95,99,100,100,100},
+	{0,6,12,21,26,31,38,48,56,60,68,72,76,84,88,97,100,100,100},
+	{0,6,13,19,27,34,37,48,56,60,68,72,76,84,98,98,98,98,100},
+	{0,6,14,21,25,33,37,47,56,60,65,73,77,85,94,100,100,100,100},
+	{0,6,12,18,27,31,40,48,52,61,65,74,82,82,96,96,100,100,100},
+	{0,6,13,19,26,33,37,48,54,64,64,72,81,89,89,100,100,100,100},
+	{0,6,11,20,27,31,39,46,57,62,67,75,79,84,93,100,100,100,100},
+	{0,5,13,19,24,33,38,45,54,60,65,74,78,83,100,100,100,100,100},
+	{0,5,14,17,26,31,39,47,52,58,68,72,81,82,91,98,98,98,100},
+	{0,1,13,19,28,33,37,45,55,61,67,71,76,85,97,97,97,100,100},
+	{0,1,12,19,25,31,40,48,53,58,65,75,80,84,95,96,96,100,100},
+	{0,1,12,18,26,32,37,45,55,61,67,72,77,87,92,99,100,100,100},
+	{0,1,11,18,27,33,37,47,51,58,64,69,74,84,95,96,100,100,100},
+	{0,1,10,19,28,34,38,48,54,61,67,72,77,87,92,99,100,100,100},
+	{0,1,10,19,28,35,41,46,51,57,69,69,74,85,90,97,97,100,100},
+	{0,1,9,18,22,31,37,48,54,59,65,77,77,82,93,100,100,100,100},
+	{0,1,9,18,23,32,38,44,55,62,67,73,74,85,91,98,98,98,100},
+	{0,1,10,19,25,34,39,47,52,59,65,77,77,82,95,95,100,100,100},
+	{0,1,10,19,26,35,42,50,55,62,67,68,74,85,99,98,99,99,100},
+	{0,1,9,18,27,28,37,45,52,59,64,71,77,83,95,96,100,96,100},
+	{0,1,9,18,27,30,39,47,54,59,66,71,77,84,90,98,98,98,100},
+	{0,1,9,18,27,32,39,47,53,60,67,74,74,86,93,99,100,100,100},
+	{0,1,9,18,23,34,40,50,55,56,63,69,76,88,94,96,96,100,100},
+	{0,1,9,19,24,33,35,43,50,57,64,71,77,84,90,97,98,98,100},
+	{0,1,9,17,26,35,35,43,52,58,65,72,79,86,92,93,100,100,100},
+	{0,1,13,19,28,28,37,44,53,60,67,73,80,88,94,96,96,96,100},
+	{0,1,13,19,28,30,39,46,53,62,68,69,76,89,90,96,98,98,100},
+	{0,1,13,16,25,32,38,48,54,56,63,69,78,83,92,93,100,100,100},
+	{0,1,13,16,23,34,40,42,49,58,64,73,80,87,88,96,100,100,100},
+	{0,1,9,15,24,33,34,41,50,59,66,67,75,83,89,98,98,98,100},
+	{0,1,9,20,24,33,36,43,52,61,68,69,75,85,85,100,100,100,100},
+	{0,1,10,18,27,27,36,46,52,61,62,71,80,87,88,96,100,100,100},
+	{0,1,10,18,26,29,38,45,54,55,64,73,80,81,89,96,97,97,100},
+	{0,1,10,17,26,29,38,39,54,55,64,73,74,89,89,98,99,99,100},
+	{0,1,10,17,22,28,40,47,48,57,66,67,75,82,91,100,100,100,100},
+	{0,1,10,16,25,31,40,41,50,59,68,77,75,85,94,94,100,100,100},
+	{0,1,10,16,21,30,39,40,49,58,67,68,77,87,87,95,100,100,100},
+	{0,1,10,15,24,30,42,40,52,61,61,70,79,89,89,95,97,97,100},
+	{0,1,14,15,24,33,32,42,51,60,60,72,81,91,91,91,99,99,100},
+	{0,1,13,14,23,32,32,45,54,54,63,72,81,82,91,100,100,100,100},
+	{0,1,9,13,23,31,34,44,56,56,65,74,74,84,93,94,100,100,100},
+	{0,1,9,13,22,31,34,47,47,56,65,74,76,86,95,95,95,100,100},
+	{0,1,9,13,21,24,36,49,49,58,67,67,76,86,95,95,97,97,100},
+	{0,1,9,13,21,24,36,49,48,57,66,69,78,88,88,90,99,99,100},
+	{0,1,9,13,21,27,39,39,51,60,59,68,81,81,90,99,100,100,100},
+	{0,1,9,15,24,26,38,39,51,53,62,71,80,81,93,94,94,100,100},
+	{0,1,10,18,24,26,38,42,54,52,61,74,73,86,95,95,100,96,100},
+	{0,1,10,14,23,29,41,41,54,52,61,74,72,86,95,97,97,97,100},
+	{0,1,10,14,23,29,41,41,54,55,64,73,75,88,87,96,98,98,100},
+	{0,1,10,13,22,28,30,44,45,54,56,65,74,88,86,99,100,100,100},
+	{0,1,10,13,22,31,30,47,45,54,57,65,77,87,89,98,100,100,100},
+	{0,1,10,18,22,31,30,47,44,58,67,64,77,79,88,91,99,100,100},
+	{0,1,10,18,22,31,33,50,48,50,58,67,79,78,91,100,99,100,100},
+	{0,1,10,12,21,30,33,49,47,50,57,66,79,81,90,92,98,100,100},
+	{0,1,10,12,21,30,36,49,47,51,60,69,70,80,93,95,95,100,100},
+	{0,1,10,12,21,30,36,37,51,50,59,61,69,83,96,97,99,100,100},
+	{0,1,10,12,21,30,39,36,50,50,59,72,69,83,84,97,99,100,100},
+	{0,1,10,12,21,30,39,36,50,50,59,72,73,83,84,97,99,100,100},
+	{0,1,10,12,20,29,38,40,54,53,54,63,72,86,84,100,98,100,100},
+	{0,1,10,12,20,29,38,40,54,53,54,63,72,86,83,100,98,100,100},
+	{0,1,10,12,20,29,38,39,53,52,54,62,71,85,86,99,97,100,100},
+	{0,1,10,14,23,32,41,39,53,52,54,62,71,85,86,99,100,100,100},
+	{0,1,10,14,19,28,37,38,42,51,60,61,74,84,85,98,100,100,100},
+	{0,1,10,14,19,28,37,38,42,51,60,61,74,84,85,98,99,100,100},
+	{0,1,10,13,18,27,36,42,41,50,59,60,73,83,85,97,99,100,100},
+	{0,1,10,13,18,27,36,41,41,54,63,60,73,83,84,97,98,100,100},
+	{0,1,10,13,18,27,36,41,41,54,63,60,73,83,84,97,98,100,100},
+	{0,1,10,13,18,26,35,40,40,53,54,63,72,74,83,100,97,100,100},
+	{0,1,10,12,21,26,35,40,40,53,54,63,72,74,83,100,97,100,100},
+	{0,1,10,12,21,25,34,39,39,52,53,62,71,85,86,99,100,100,100},
+	{0,1,10,12,21,25,34,39,39,52,53,62,71,85,86,99,100,100,100},
+	{0,1,10,12,20,24,33,38,42,51,52,61,74,84,85,98,99,100,100},
+	{0,1,10,12,20,24,33,38,42,51,52,61,74,84,85,98,99,99,100},
+	{0,1,10,10,19,23,32,42,41,50,51,60,73,83,84,97,98,99,100},
+	{0,1,10,10,19,23,32,42,41,50,51,60,73,83,84,97,97,98,100},
+	{0,1,10,10,19,23,32,42,41,50,51,60,73,74,83,97,97,97,100},
+	{0,1,10,10,19,23,32,42,41,50,50,59,73,74,83,96,96,100,100},
+	{0,1,10,10,19,23,32,42,41,50,54,63,63,73,82,86,100,99,100},
+	{0,1,10,10,19,23,32,42,41,50,54,63,62,72,86,85,99,98,100},
+	{0,1,10,10,19,23,32,42,41,50,54,63,62,72,86,84,99,97,100},
+	{0,1,10,10,19,23,32,42,41,50,53,62,61,71,74,83,98,96,100},
+	{0,1,10,10,19,23,32,42,41,50,53,62,54,70,73,82,97,100,100},
+	{0,1,10,10,19,23,32,42,40,49,52,61,54,63,72,81,96,99,100}
+};
+
+#endif /* TORQUE_SPLIT_TABLE_H_ */